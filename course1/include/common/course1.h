@@ -29,7 +29,31 @@
 #define TEST_MEMMOVE_LENGTH (16)
 #define TEST_ERROR          (1)
 #define TEST_NO_ERROR       (0)
-#define TESTCOUNT           (8)
+#define TESTCOUNT           (30)
+
+#define MEMDIFF_MAX_RANGES  (4)
+#define WORD_VECTOR_TEST_LENGTH (1000)
+#define WORD_VECTOR_MAP_TEST_LENGTH (3 * WORD_VECTOR_MAP_THRESHOLD_B / 4)
+#define BLOCK_POOL_TEST_COUNT   (4)
+#define BLOCK_POOL_TEST_SIZE_W  (4)
+#define ITOA_ARRAY_TEST_COUNT   (5)
+#define ATOI_STREAM_TEST_COUNT  (5)
+#define FTOA_TEST_Q15           (-24576)
+#define OUTPUT_TEST_LENGTH      (3 * OUTPUT_BUFFER_SIZE / 10 * 10 + 10)
+#define OUTPUT_TEST_SINK_CHUNK  (7)
+#define DLOG_TEST_WORDS         (16)
+#define PRINT_TABLE_TEXT_SIZE   (1024)
+#define VARINT_TEST_COUNT       (8)
+#define DATA_BASES_TEST_COUNT   (5)
+#define ITOA_LEN_TEST_COUNT     (8)
+#define STATS_TEST_LENGTH       (400)
+#define STATS_TEST_SEED         (12345)
+#define KTH_TEST_LENGTH         (100)
+#define WINDOW_TEST_CAPACITY    (16)
+#define MEM_SMALL_MAX_LENGTH    (64)
+#define MEM_SMALL_GUARD         (16)
+#define MEM_SMALL_SIZE_B        (MEM_SMALL_MAX_LENGTH + 2 * MEM_SMALL_GUARD)
+#define MEM_SMALL_SHIFT_COUNT   (5)
 
 #define BASE_16 16
 #define BASE_10 10
@@ -64,6 +88,172 @@ int8_t test_data1();
  */
 int8_t test_data2();
 
+/**
+ * @brief function to run course1 64-bit data operations
+ * 
+ * This function calls the my_itoa64 and my_atoi64 functions to validate
+ * they work as expected for decimal and hexadecimal numbers, and that a
+ * value out of the 64-bit range is reported as an overflow.
+ *
+ * @return void
+ */
+int8_t test_data64();
+
+/**
+ * @brief function to run course1 float and fixed-point formatting
+ * 
+ * This function calls the my_ftoa and my_qtoa functions to validate they
+ * produce the expected strings for a plain float, a float printed with an
+ * exponent and a negative Q15 value.
+ *
+ * @return void
+ */
+int8_t test_ftoa();
+
+/**
+ * @brief function to run course1 buffered output operations
+ * 
+ * This function writes several buffer loads of text through the output
+ * layer into a sink that accepts only a few bytes per call, and checks
+ * every byte arrives once and in order.
+ *
+ * @return void
+ */
+int8_t test_output();
+
+/**
+ * @brief function to run course1 deferred logging operations
+ * 
+ * This function logs records with and without arguments and reads them
+ * back, then overfills the ring buffer and checks that whole records are
+ * kept in order and the overflow is counted as dropped records.
+ *
+ * @return void
+ */
+int8_t test_dlog();
+
+/**
+ * @brief function to run course1 table-driven byte printing
+ * 
+ * This function prints every byte value through output_u8_array into a
+ * capturing sink and compares the text with my_itoa output, then checks
+ * a few values in hexadecimal.
+ *
+ * @return void
+ */
+int8_t test_print_table();
+
+/**
+ * @brief function to run course1 binary-to-text codec operations
+ * 
+ * This function round-trips a data set through hex_encode/hex_decode and
+ * base64_encode/base64_decode, checks a known base64 vector and a bad
+ * character, and checks the size of a hexdump.
+ *
+ * @return void
+ */
+int8_t test_codec();
+
+/**
+ * @brief function to run course1 varint operations
+ * 
+ * This function encodes int32 values including the extremes as zigzag
+ * varints, checks the precomputed size and decodes them back, checks a
+ * truncated input is rejected, and round-trips two int64 values.
+ *
+ * @return void
+ */
+int8_t test_varint();
+
+/**
+ * @brief function to run course1 per-base conversion variants
+ * 
+ * This function checks that my_itoa and my_atoi called with a constant
+ * base (which selects the per-base variants) give the same results as
+ * the generic functions with a runtime base, for bases 2, 8, 10 and 16.
+ *
+ * @return void
+ */
+int8_t test_data_bases();
+
+/**
+ * @brief function to run course1 output length precomputation
+ * 
+ * This function checks my_itoa_len against the length my_itoa writes,
+ * and my_itoa_array_len against the length my_itoa_array reports, with
+ * and without a separator and with an output buffer that is too short.
+ *
+ * @return void
+ */
+int8_t test_itoa_len();
+
+/**
+ * @brief function to run course1 histogram median
+ * 
+ * This function compares find_median_histogram against the sorting
+ * find_median for odd and even lengths of pseudo-random data, and checks
+ * that the histogram median leaves its input unchanged.
+ *
+ * @return void
+ */
+int8_t test_median_histogram();
+
+/**
+ * @brief function to run course1 fused statistics
+ * 
+ * This function checks each field of compute_statistics against the
+ * separate find_ functions or a direct count over the data, checks the
+ * input is left unchanged, and checks the empty array case.
+ *
+ * @return void
+ */
+int8_t test_compute_statistics();
+
+/**
+ * @brief function to run course1 vectorized min, max and mean
+ * 
+ * This function compares find_minimum, find_maximum and find_mean against
+ * a plain loop for every start alignment and many tail lengths, and with
+ * the extremes placed at the first and last element.
+ *
+ * @return void
+ */
+int8_t test_stats_simd();
+
+/**
+ * @brief function to run course1 order statistics
+ * 
+ * This function checks find_kth_i32 at every rank of data with repeats
+ * against a sorted copy, checks the input is left unchanged, and checks
+ * even and odd length medians, including a uint16 median that would
+ * overflow without widening.
+ *
+ * @return void
+ */
+int8_t test_find_kth();
+
+/**
+ * @brief function to run course1 streaming statistics
+ * 
+ * This function feeds part of an array value by value and the rest as a
+ * block into two accumulators, merges them and checks the snapshot and
+ * percentiles against compute_statistics and find_kth on the whole array.
+ *
+ * @return void
+ */
+int8_t test_stats_accumulator();
+
+/**
+ * @brief function to run course1 sliding window statistics
+ * 
+ * This function pushes a drifting noisy signal through a 16-sample window
+ * and after every sample compares the moving minimum, maximum, mean and
+ * median with the array functions over the samples the window covers.
+ *
+ * @return void
+ */
+int8_t test_stats_window();
+
 /**
  * @brief function to test the non-overlapped memmove operation
  * 
@@ -119,6 +309,17 @@ int8_t test_memcopy();
  */
 int8_t test_memset();
 
+/**
+ * @brief function to test memmove and memset on every short length
+ *
+ * This function runs my_memmove for each length from 0 to 64 with the
+ * source before, on and after the destination, and my_memset/my_memzero
+ * for the same lengths, checking the bytes either side are untouched.
+ *
+ * @return void
+ */
+int8_t test_mem_small();
+
 /**
  * @brief function to test the reverse functionality
  * 
@@ -129,5 +330,68 @@ int8_t test_memset();
  */
 int8_t test_reverse();
 
+/**
+ * @brief function to test the memdiff functionality
+ * 
+ * This function calls the my_memdiff function to check that changed byte
+ * ranges are reported correctly, including the early-exit mode and the
+ * case where there are more ranges than output slots.
+ *
+ * @return void
+ */
+int8_t test_memdiff();
+
+/**
+ * @brief function to test the bulk bit manipulation functionality
+ * 
+ * This function calls my_popcount, my_bitcount_per_position and
+ * my_bitreverse and compares them against a bit-by-bit computation.
+ *
+ * @return void
+ */
+int8_t test_bitops();
+
+/**
+ * @brief function to test the word vector functionality
+ * 
+ * This function appends words to a word vector past its inline storage,
+ * shrinks it and checks the contents survive every reallocation.
+ *
+ * @return void
+ */
+int8_t test_word_vector();
+
+/**
+ * @brief function to test the lock-free block pool functionality
+ * 
+ * This function drains a small block pool, checks that every block is
+ * distinct and that an exhausted pool returns NULL, then frees and
+ * reallocates a block.
+ *
+ * @return void
+ */
+int8_t test_block_pool();
+
+/**
+ * @brief function to test the batch integer to ASCII conversion
+ * 
+ * This function calls my_itoa_array to format several numbers into one
+ * buffer, then repeats with a buffer that is too small to check that only
+ * whole values are written and the full length is reported.
+ *
+ * @return void
+ */
+int8_t test_itoa_array();
+
+/**
+ * @brief function to test the streaming ASCII to integer parser
+ * 
+ * This function feeds delimited numbers in several chunks, with one number
+ * split across a chunk boundary, and checks the uint8 values produced.
+ *
+ * @return void
+ */
+int8_t test_atoi_stream();
+
 #endif /* __COURSE1_H__ */
 
@@ -2,35 +2,485 @@
 #define __DATA_H__
 
 #include <stdint.h>
+#include <stddef.h>
+
+#define ITOA_MAX_CHARS (33)  /* Longest my_itoa() output: '-' and 32 bits */
+#define ITOA_MAX_SIZE (ITOA_MAX_CHARS + 1) /* my_itoa() buffer, with '\0' */
+#define FTOA_MAX_CHARS (24)  /* Buffer size that fits any my_ftoa() output */
+#define FTOA_FIXED_DIGITS (9) /* Integer digits printed before using 'e' */
+
+/* Output sizes of the binary-to-text encoders */
+#define HEX_ENCODED_LENGTH(n)    (2 * (n))
+#define BASE64_ENCODED_LENGTH(n) (((n) + 2) / 3 * 4)
+#define HEXDUMP_BYTES_PER_LINE   (16)
+#define HEXDUMP_LINE_CHARS       (79)  /* Longest hexdump() line with '\n' */
+#define HEXDUMP_LENGTH(n) \
+    (((n) + HEXDUMP_BYTES_PER_LINE - 1) / HEXDUMP_BYTES_PER_LINE * \
+     HEXDUMP_LINE_CHARS)
+
+/* Longest LEB128 varint of a 32-bit and a 64-bit value */
+#define VARINT32_MAX_BYTES (5)
+#define VARINT64_MAX_BYTES (10)
+
+/* Returned by the decoders on malformed input */
+#define DATA_DECODE_ERROR ((size_t) -1)
+
+#define Q15_FRAC_BITS (15)
+#define Q31_FRAC_BITS (31)
+
+/**
+ * @brief State of a streaming delimited-integer parser
+ *
+ * Tokens are maximal runs of digits in `base`, optionally preceded by '-';
+ * every other byte (space, comma, newline, ...) is a delimiter. A token
+ * may be split across any number of input chunks.
+ */
+typedef struct {
+    uint32_t base;        /* Numeric base of the tokens */
+    uint32_t value;       /* Magnitude of the pending token */
+    uint8_t in_token;     /* A token has started but not ended */
+    uint8_t has_digits;   /* The pending token has at least one digit */
+    uint8_t is_negative;  /* The pending token started with '-' */
+    uint8_t overflow;     /* The pending token's magnitude exceeded 32 bits */
+    int32_t * out_i32;    /* Output array for int32 values, or NULL */
+    uint8_t * out_u8;     /* Output array for uint8 values, or NULL */
+    size_t out_cap;       /* Number of values the output array holds */
+    size_t count;         /* Number of values stored in the output array */
+} atoi_stream_t;
 
 /**
  * @brief Converts integer to ASCII string
  *
  * This function converts a signed 32-bit integer into a null-terminated
- * ASCII string for the specified base (2 to 16). The resulting string is
- * stored in the provided pointer using pointer arithmetic.
+ * ASCII string for the specified base (2 to 16, or 32). The resulting string is
+ * stored in the provided pointer using pointer arithmetic. Negative values
+ * are written as a '-' followed by the magnitude in every base.
+ *
+ * Base 10 is division-free: the digit count is computed up front from the
+ * bit length, and digits are written two at a time from a lookup table.
+ * Power-of-two bases (2, 4, 8, 16, 32) use shifts and masks only; base 16
+ * converts all eight nibbles of a word at once.
  *
  * @param data The signed integer to convert
  * @param ptr The pointer to the output buffer
- * @param base The numeric base to convert to (2 to 16)
+ * @param base The numeric base to convert to (2 to 16, or 32)
  *
  * @return Length of the resulting string including null terminator
  */
 uint8_t my_itoa(int32_t data, uint8_t * ptr, uint32_t base);
 
+/**
+ * @brief Converts a 64-bit integer to ASCII string
+ *
+ * Same conventions as my_itoa() for a signed 64-bit value. The value is
+ * reduced with 32-bit divides on 16-bit limbs (or shifts for power-of-two
+ * bases) until it fits the 32-bit kernels, so no 64-bit division is ever
+ * needed on the Cortex-M4.
+ *
+ * @param data The signed integer to convert
+ * @param ptr The pointer to the output buffer (at least 66 bytes)
+ * @param base The numeric base to convert to (2 to 16, or 32)
+ *
+ * @return Length of the resulting string including null terminator
+ */
+uint8_t my_itoa64(int64_t data, uint8_t * ptr, uint32_t base);
+
+/**
+ * @brief Converts a float to a short round-trip ASCII string
+ *
+ * Writes the shortest decimal digits that read back as exactly `data`,
+ * in plain notation ("12.5", "0.001") or with an exponent ("1.5e-7") for
+ * very large or small magnitudes. Uses Grisu2 on integer arithmetic only,
+ * with a 12-entry table of cached powers of ten, so no floating-point
+ * printf is needed. The few results Grisu2 cannot prove shortest (under
+ * 0.5% of floats) are settled with exact 192-bit integer comparisons.
+ *
+ * @param data The float to convert
+ * @param ptr The pointer to the output buffer (at least FTOA_MAX_CHARS)
+ *
+ * @return Length of the resulting string including null terminator
+ */
+uint8_t my_ftoa(float data, uint8_t * ptr);
+
+/**
+ * @brief Converts a fixed-point number to an ASCII decimal string
+ *
+ * Interprets `data` as a signed fixed-point value with `frac_bits`
+ * fractional bits (Q15_FRAC_BITS for Q15, Q31_FRAC_BITS for Q31) and
+ * writes it with exactly `decimals` fractional digits, rounded half up.
+ * Integer arithmetic only.
+ *
+ * @param data The fixed-point value to convert
+ * @param frac_bits Number of fractional bits (0 to 31)
+ * @param decimals Number of fractional digits to print (0 to 9)
+ * @param ptr The pointer to the output buffer
+ *
+ * @return Length of the resulting string including null terminator
+ */
+uint8_t my_qtoa(int32_t data, uint8_t frac_bits, uint8_t decimals,
+                uint8_t * ptr);
+
+/**
+ * @brief Returns the number of characters my_itoa() writes for a value
+ *
+ * The length excludes the null terminator, so it is one less than the
+ * value my_itoa() returns. Constant time for base 10 (CLZ and a table of
+ * powers of 10) and for power-of-two bases (the bit length).
+ *
+ * @param value The integer to measure
+ * @param base The numeric base (2 to 16, or 32)
+ *
+ * @return Number of characters, including any '-' sign
+ */
+uint8_t my_itoa_len(int32_t value, uint32_t base);
+
+/**
+ * @brief Returns the length my_itoa_array() needs for an array
+ *
+ * Lets the caller allocate the exact output buffer once. On HOST, base
+ * 10 lengths are summed four values at a time with SSE2 compares.
+ *
+ * @param values Pointer to the integers to measure
+ * @param n Number of integers
+ * @param base The numeric base (2 to 16, or 32)
+ * @param sep Separator character, or '\0' for none
+ *
+ * @return Number of characters my_itoa_array() writes for the array
+ */
+size_t my_itoa_array_len(int32_t * values, size_t n, uint32_t base,
+                         uint8_t sep);
+
+/**
+ * @brief Converts an array of integers to one separated ASCII string
+ *
+ * Writes the `n` values at `values` in the given base into `out`, with the
+ * character `sep` between consecutive values (no separator if `sep` is
+ * '\0'). No null terminator is written. Only whole values are written: if
+ * the output does not fit, `out` holds the values that did fit and the
+ * return value reports the full length needed, so the caller can retry
+ * with a buffer of exactly that size.
+ *
+ * @param values Pointer to the integers to convert
+ * @param n Number of integers to convert
+ * @param base The numeric base to convert to (2 to 16, or 32)
+ * @param sep Separator character, or '\0' for none
+ * @param out Pointer to the output buffer
+ * @param out_cap Size of the output buffer in bytes
+ *
+ * @return Length of the complete output; more space is needed if this is
+ *         greater than `out_cap`
+ */
+size_t my_itoa_array(int32_t * values, size_t n, uint32_t base, uint8_t sep,
+                     uint8_t * out, size_t out_cap);
+
 /**
  * @brief Converts ASCII string to integer
  *
  * This function converts a null-terminated ASCII string to a signed 32-bit
- * integer using the specified base (2 to 16). The conversion uses pointer
- * arithmetic and handles signed numbers.
+ * integer using the specified base (2 to 16, or 32). The conversion uses
+ * pointer arithmetic and handles signed numbers. Conversion stops at the
+ * null terminator, so the length returned by my_itoa() can be passed as
+ * `digits`. Power-of-two bases accumulate with shifts instead of
+ * multiplies, and decimal and hex strings are consumed a register word of
+ * characters per step (16 decimal digits per step with SSSE3 on HOST).
  *
  * @param ptr The pointer to the ASCII input string
  * @param digits The number of digits in the ASCII string
- * @param base The numeric base to convert from (2 to 16)
+ * @param base The numeric base to convert from (2 to 16, or 32)
  *
- * @return The converted signed 32-bit integer
+ * @return The converted signed 32-bit integer, or 0 on an invalid digit
  */
 int32_t my_atoi(uint8_t * ptr, uint8_t digits, uint32_t base);
 
+/**
+ * @brief Per-base variants of my_itoa() and my_atoi()
+ *
+ * Same results as my_itoa(data, ptr, N) and my_atoi(ptr, digits, N), with
+ * the base fixed at compile time so it folds into the conversion kernels.
+ * Calls to my_itoa()/my_atoi() with a constant base 2, 8, 10 or 16 are
+ * routed to these by the macros below; other bases and runtime bases use
+ * the generic functions.
+ */
+uint8_t my_itoa_base2(int32_t data, uint8_t * ptr);
+uint8_t my_itoa_base8(int32_t data, uint8_t * ptr);
+uint8_t my_itoa_base10(int32_t data, uint8_t * ptr);
+uint8_t my_itoa_base16(int32_t data, uint8_t * ptr);
+int32_t my_atoi_base2(uint8_t * ptr, uint8_t digits);
+int32_t my_atoi_base8(uint8_t * ptr, uint8_t digits);
+int32_t my_atoi_base10(uint8_t * ptr, uint8_t digits);
+int32_t my_atoi_base16(uint8_t * ptr, uint8_t digits);
+
+/* True when `base` is the compile-time constant `value` */
+#define DATA_CONST_BASE(base, value) \
+    (__builtin_constant_p(base) && (base) == (value))
+
+#define my_itoa(data, ptr, base) \
+    (DATA_CONST_BASE(base, 10) ? my_itoa_base10((data), (ptr)) : \
+     DATA_CONST_BASE(base, 16) ? my_itoa_base16((data), (ptr)) : \
+     DATA_CONST_BASE(base, 8)  ? my_itoa_base8((data), (ptr)) : \
+     DATA_CONST_BASE(base, 2)  ? my_itoa_base2((data), (ptr)) : \
+     (my_itoa)((data), (ptr), (base)))
+
+#define my_atoi(ptr, digits, base) \
+    (DATA_CONST_BASE(base, 10) ? my_atoi_base10((ptr), (digits)) : \
+     DATA_CONST_BASE(base, 16) ? my_atoi_base16((ptr), (digits)) : \
+     DATA_CONST_BASE(base, 8)  ? my_atoi_base8((ptr), (digits)) : \
+     DATA_CONST_BASE(base, 2)  ? my_atoi_base2((ptr), (digits)) : \
+     (my_atoi)((ptr), (digits), (base)))
+
+/**
+ * @brief Converts ASCII string to a 64-bit integer
+ *
+ * Same conventions as my_atoi() for a signed 64-bit result. Digits are
+ * accumulated in 32-bit chunks. Overflow is detected from the count of
+ * significant digits and one final comparison, not per digit; an
+ * out-of-range value saturates to INT64_MAX or INT64_MIN.
+ *
+ * @param ptr The pointer to the ASCII input string
+ * @param digits The number of digits in the ASCII string
+ * @param base The numeric base to convert from (2 to 16, or 32)
+ * @param overflow Set to 1 if the value was out of range, else 0 (may be
+ *                 NULL)
+ *
+ * @return The converted signed 64-bit integer, or 0 on an invalid digit
+ */
+int64_t my_atoi64(uint8_t * ptr, uint8_t digits, uint32_t base,
+                  uint8_t * overflow);
+
+/**
+ * @brief Initializes a streaming ASCII to integer parser
+ *
+ * An output array must be attached with atoi_stream_output_i32() or
+ * atoi_stream_output_u8() before feeding data.
+ *
+ * @param stream Pointer to the parser state
+ * @param base The numeric base of the input (2 to 16, or 32)
+ *
+ * @return void
+ */
+void atoi_stream_init(atoi_stream_t * stream, uint32_t base);
+
+/**
+ * @brief Attaches an int32 output array to a streaming parser
+ *
+ * Also used to hand the parser an empty array after the caller has
+ * consumed the previous one; the stored value count is reset to zero.
+ *
+ * @param stream Pointer to the parser state
+ * @param out Pointer to the output array
+ * @param out_cap Number of values the output array holds
+ *
+ * @return void
+ */
+void atoi_stream_output_i32(atoi_stream_t * stream, int32_t * out,
+                            size_t out_cap);
+
+/**
+ * @brief Attaches a uint8 output array to a streaming parser
+ *
+ * Values are clamped to 0..255 so the array can be passed straight to
+ * the stats functions. The stored value count is reset to zero.
+ *
+ * @param stream Pointer to the parser state
+ * @param out Pointer to the output array
+ * @param out_cap Number of values the output array holds
+ *
+ * @return void
+ */
+void atoi_stream_output_u8(atoi_stream_t * stream, uint8_t * out,
+                           size_t out_cap);
+
+/**
+ * @brief Parses a chunk of delimited ASCII integers
+ *
+ * Token boundaries are located a vector (HOST) or word (MSP432) of bytes
+ * at a time, and digit runs are converted with the same word-at-a-time
+ * kernels as my_atoi(). A token cut off at the end of the chunk is kept
+ * pending and continued by the next call.
+ *
+ * Parsing stops early when a finished token does not fit in the output
+ * array. The caller then consumes the output, attaches a fresh array and
+ * feeds the rest of the chunk again.
+ *
+ * @param stream Pointer to the parser state
+ * @param chunk Pointer to the input bytes
+ * @param length Number of input bytes
+ *
+ * @return Number of input bytes consumed
+ */
+size_t atoi_stream_feed(atoi_stream_t * stream, uint8_t * chunk,
+                        size_t length);
+
+/**
+ * @brief Ends the input of a streaming parser
+ *
+ * Stores the token pending at the end of the input, if any. If the output
+ * array is full the token stays pending and this may be called again
+ * after attaching a fresh array.
+ *
+ * @param stream Pointer to the parser state
+ *
+ * @return Number of values stored in the output array
+ */
+size_t atoi_stream_finish(atoi_stream_t * stream);
+
+/**
+ * @brief Encodes bytes as hexadecimal text
+ *
+ * Writes two upper-case hex digits per byte, 16 bytes per step with SSE2
+ * on HOST and a register word at a time otherwise. No null terminator
+ * is written.
+ *
+ * @param src Pointer to the input bytes
+ * @param length Number of input bytes
+ * @param dst Pointer to the output (HEX_ENCODED_LENGTH(length) bytes)
+ *
+ * @return Number of characters written
+ */
+size_t hex_encode(uint8_t * src, size_t length, uint8_t * dst);
+
+/**
+ * @brief Decodes hexadecimal text to bytes
+ *
+ * Accepts upper- and lower-case digits. Output written before a bad
+ * character is found is left in `dst`.
+ *
+ * @param src Pointer to the hex digits
+ * @param length Number of hex digits (must be even)
+ * @param dst Pointer to the output (length / 2 bytes)
+ *
+ * @return Number of bytes written, or DATA_DECODE_ERROR on odd length or
+ *         a character that is not a hex digit
+ */
+size_t hex_decode(uint8_t * src, size_t length, uint8_t * dst);
+
+/**
+ * @brief Encodes bytes as base64 text
+ *
+ * Uses the standard alphabet with '=' padding. Encodes 12 bytes per step
+ * with SSSE3 on HOST and maps 3-byte groups with SWAR range arithmetic
+ * otherwise. No null terminator is written.
+ *
+ * @param src Pointer to the input bytes
+ * @param length Number of input bytes
+ * @param dst Pointer to the output (BASE64_ENCODED_LENGTH(length) bytes)
+ *
+ * @return Number of characters written
+ */
+size_t base64_encode(uint8_t * src, size_t length, uint8_t * dst);
+
+/**
+ * @brief Decodes base64 text to bytes
+ *
+ * Expects the standard alphabet, padded to a multiple of four characters
+ * and without whitespace. Exactly the decoded bytes are written:
+ * length / 4 * 3, less one byte per '=' of padding.
+ *
+ * @param src Pointer to the base64 characters
+ * @param length Number of characters (a multiple of four)
+ * @param dst Pointer to the output
+ *
+ * @return Number of bytes decoded, or DATA_DECODE_ERROR on bad input
+ */
+size_t base64_decode(uint8_t * src, size_t length, uint8_t * dst);
+
+/**
+ * @brief Formats bytes as a hexdump with offsets and ASCII
+ *
+ * Writes one line per HEXDUMP_BYTES_PER_LINE bytes in the usual layout:
+ * an 8-digit hex offset, the bytes in hex in two groups of eight, then
+ * the printable characters between '|' marks ('.' for the others). The
+ * whole dump goes into `dst` so it can be output with a single write.
+ * No null terminator is written.
+ *
+ * @param src Pointer to the input bytes
+ * @param length Number of input bytes
+ * @param offset Offset printed for the first byte
+ * @param dst Pointer to the output (HEXDUMP_LENGTH(length) bytes)
+ *
+ * @return Number of characters written
+ */
+size_t hexdump(uint8_t * src, size_t length, uint32_t offset, uint8_t * dst);
+
+/**
+ * @brief Returns the encoded size of an int32 array as zigzag varints
+ *
+ * Lets the caller reserve the exact output buffer for varint_encode32()
+ * once. Each value costs one CLZ, no trial encoding.
+ *
+ * @param values Pointer to the values
+ * @param n Number of values
+ *
+ * @return Number of bytes varint_encode32() will write
+ */
+size_t varint_size32(int32_t * values, size_t n);
+
+/**
+ * @brief Returns the encoded size of an int64 array as zigzag varints
+ *
+ * @param values Pointer to the values
+ * @param n Number of values
+ *
+ * @return Number of bytes varint_encode64() will write
+ */
+size_t varint_size64(int64_t * values, size_t n);
+
+/**
+ * @brief Encodes an int32 array as zigzag LEB128 varints
+ *
+ * Each value is zigzag mapped (0, -1, 1, -2, ... to 0, 1, 2, 3, ...) so
+ * small magnitudes of either sign take few bytes, then written 7 bits
+ * per byte, low group first, with the top bit set on all but the last.
+ *
+ * @param values Pointer to the values
+ * @param n Number of values
+ * @param dst Pointer to the output (varint_size32() bytes)
+ *
+ * @return Number of bytes written
+ */
+size_t varint_encode32(int32_t * values, size_t n, uint8_t * dst);
+
+/**
+ * @brief Encodes an int64 array as zigzag LEB128 varints
+ *
+ * @param values Pointer to the values
+ * @param n Number of values
+ * @param dst Pointer to the output (varint_size64() bytes)
+ *
+ * @return Number of bytes written
+ */
+size_t varint_encode64(int64_t * values, size_t n, uint8_t * dst);
+
+/**
+ * @brief Decodes zigzag LEB128 varints into an int32 array
+ *
+ * Decodes until `n` values are stored or the input ends. Each varint is
+ * read with one word load and a mask where possible, and on HOST runs of
+ * 16 one-byte values are decoded together with SSE2.
+ *
+ * @param src Pointer to the encoded bytes
+ * @param length Number of encoded bytes
+ * @param values Pointer to the output values
+ * @param n Number of values the output holds
+ *
+ * @return Number of values decoded, or DATA_DECODE_ERROR if a varint is
+ *         cut off or does not fit 32 bits
+ */
+size_t varint_decode32(uint8_t * src, size_t length, int32_t * values,
+                       size_t n);
+
+/**
+ * @brief Decodes zigzag LEB128 varints into an int64 array
+ *
+ * @param src Pointer to the encoded bytes
+ * @param length Number of encoded bytes
+ * @param values Pointer to the output values
+ * @param n Number of values the output holds
+ *
+ * @return Number of values decoded, or DATA_DECODE_ERROR if a varint is
+ *         cut off or does not fit 64 bits
+ */
+size_t varint_decode64(uint8_t * src, size_t length, int64_t * values,
+                       size_t n);
+
 #endif /* __DATA_H__ */
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are 
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material. 
+ *
+ *****************************************************************************/
+/**
+ * @file dlog.h
+ * @brief Deferred binary logging
+ *
+ * DLOG() takes printf-style arguments but does no formatting. It stores a
+ * record of one header word (format ID and argument count) and up to
+ * DLOG_MAX_ARGS raw argument words in a lock-free ring buffer, so it is
+ * cheap enough for interrupt handlers and tight loops.
+ *
+ * The format strings are placed in the `dlog_fmt` section and the ID of a
+ * string is its offset in that section. `make dlog` extracts the section
+ * and builds tools/dlog_decode, which turns flushed records back into
+ * text. Arguments are stored as 32-bit words, so only integer conversions
+ * (%d %i %u %o %x %X %c) decode to their original values.
+ *
+ * Building with LOG=DEFERRED maps PRINTF onto DLOG.
+ *
+ * @author
+ * @date
+ *
+ */
+#ifndef __DLOG_H__
+#define __DLOG_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "output.h"
+
+#define DLOG_BUFFER_WORDS (1024)  /* Ring buffer size, a power of two */
+#define DLOG_MAX_ARGS     (4)
+
+/* Header word: format ID in bits 31-16, argument count in 15-8, marker */
+#define DLOG_MARKER            (0x5Au)
+#define DLOG_HEADER(id, count) (((uint32_t)(id) << 16) | \
+                                ((uint32_t)(count) << 8) | DLOG_MARKER)
+#define DLOG_HEADER_ID(header)    ((header) >> 16)
+#define DLOG_HEADER_COUNT(header) (((header) >> 8) & 0xFFu)
+#define DLOG_HEADER_VALID(header) (((header) & 0xFFu) == DLOG_MARKER)
+
+/* Start of the format string section, provided by the linker */
+extern const char __start_dlog_fmt[];
+
+#define DLOG_RECORD(count, fmt, a, b, c, d) do { \
+    static const char dlog_fmt_str[] \
+        __attribute__((section("dlog_fmt"), used)) = fmt; \
+    dlog_write((uint32_t)(dlog_fmt_str - __start_dlog_fmt), (count), \
+               (uint32_t)(uintptr_t)(a), (uint32_t)(uintptr_t)(b), \
+               (uint32_t)(uintptr_t)(c), (uint32_t)(uintptr_t)(d)); \
+} while (0)
+
+#define DLOG0(fmt)             DLOG_RECORD(0, fmt, 0, 0, 0, 0)
+#define DLOG1(fmt, a)          DLOG_RECORD(1, fmt, a, 0, 0, 0)
+#define DLOG2(fmt, a, b)       DLOG_RECORD(2, fmt, a, b, 0, 0)
+#define DLOG3(fmt, a, b, c)    DLOG_RECORD(3, fmt, a, b, c, 0)
+#define DLOG4(fmt, a, b, c, d) DLOG_RECORD(4, fmt, a, b, c, d)
+
+/* Picks DLOG0..DLOG4 from the number of arguments after the format */
+#define DLOG_SELECT(fmt, a, b, c, d, name, ...) name
+#define DLOG(...) \
+    DLOG_SELECT(__VA_ARGS__, DLOG4, DLOG3, DLOG2, DLOG1, DLOG0, ~)(__VA_ARGS__)
+
+/**
+ * @brief Appends one record to the log ring buffer
+ *
+ * Safe to call from interrupt handlers and from several threads. The
+ * record is dropped, and counted by dlog_dropped(), if the ring is full.
+ * Normally called through DLOG().
+ *
+ * @param id Format string ID
+ * @param count Number of argument words (0 to DLOG_MAX_ARGS)
+ * @param a0 First argument word
+ * @param a1 Second argument word
+ * @param a2 Third argument word
+ * @param a3 Fourth argument word
+ *
+ * @return void
+ */
+void dlog_write(uint32_t id, uint32_t count, uint32_t a0, uint32_t a1,
+                uint32_t a2, uint32_t a3);
+
+/**
+ * @brief Removes whole records from the log ring buffer
+ *
+ * Copies complete records, oldest first, until the next one would not
+ * fit in `max_words`. Only one reader may call this at a time.
+ *
+ * @param dst Pointer to the destination words
+ * @param max_words Number of words `dst` can hold
+ *
+ * @return Number of words copied
+ */
+size_t dlog_read(uint32_t * dst, size_t max_words);
+
+/**
+ * @brief Sends all logged records to a sink as raw bytes
+ *
+ * With a NULL sink, records are written to standard error on HOST and
+ * discarded on the target.
+ *
+ * @param sink The sink function, or NULL
+ *
+ * @return Number of words removed from the ring buffer
+ */
+size_t dlog_flush(output_sink_t sink);
+
+/**
+ * @brief Returns the number of records dropped because the ring was full
+ *
+ * @return Number of dropped records
+ */
+uint32_t dlog_dropped(void);
+
+#endif /* __DLOG_H__ */
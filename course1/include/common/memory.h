@@ -28,6 +28,22 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/**
+ * @brief A contiguous range of bytes inside a buffer
+ *
+ * Used by my_memdiff() to report which parts of a buffer differ from a
+ * reference copy.
+ */
+typedef struct {
+    size_t offset;  /* Byte offset of the first byte in the range */
+    size_t length;  /* Number of bytes in the range */
+} mem_range_t;
+
+/* 32-bit word that may live at any byte address */
+typedef struct __attribute__((packed)) {
+    uint32_t word;
+} unaligned_word_t;
+
 /**
  * @brief Moves a block of memory handling overlaps
  *
@@ -93,6 +109,114 @@ uint8_t * my_memzero(uint8_t * src, size_t length);
  */
 uint8_t * my_reverse(uint8_t * src, size_t length);
 
+#define WORD_VECTOR_INLINE_W (8)  /* Words stored without touching the heap */
+
+/* Vectors of at least this many bytes are kept in their own mapping */
+#ifndef WORD_VECTOR_MAP_THRESHOLD_B
+#define WORD_VECTOR_MAP_THRESHOLD_B (64 * 1024)
+#endif
+
+/**
+ * @brief Growable array of 32-bit words
+ *
+ * The first WORD_VECTOR_INLINE_W words live inside the structure itself;
+ * larger contents move to the heap and, on HOST, to an mremap()-able
+ * mapping once they reach WORD_VECTOR_MAP_THRESHOLD_B bytes. Because `data`
+ * may point into the structure, a vector must not be copied by value.
+ */
+typedef struct {
+    uint32_t * data;      /* First word of the current storage */
+    size_t size;          /* Number of words in use */
+    size_t capacity;      /* Number of words available at `data` */
+    uint8_t storage;      /* Where `data` lives (inline, heap or mapping) */
+    uint32_t inline_words[WORD_VECTOR_INLINE_W];
+} word_vector_t;
+
+#define BLOCK_POOL_MAX_BLOCKS (0xFFFF)  /* Blocks addressable by a pool */
+
+/**
+ * @brief Lock-free pool of fixed-size memory blocks
+ *
+ * Free blocks form a singly linked list threaded through the blocks
+ * themselves. `head` packs the index (plus one) of the first free block in
+ * its low 16 bits and a modification tag in its high 16 bits.
+ */
+typedef struct {
+    volatile uint32_t head;  /* Tag and first free block, 0 index if empty */
+    uint8_t * base;          /* Start of the block storage */
+    size_t block_size;       /* Size of one block in bytes */
+    size_t count;            /* Number of blocks in the pool */
+} block_pool_t;
+
+/**
+ * @brief Finds the byte ranges in which two buffers differ
+ *
+ * Compares `length` bytes of `a` and `b` and writes the maximal runs of
+ * differing bytes to `ranges` in ascending order. Blocks are compared at
+ * vector width (16 bytes) on HOST and at word width on MSP432, so equal
+ * regions are skipped quickly.
+ *
+ * If more than `max_ranges` runs exist, the last reported range is extended
+ * to cover all remaining differences, so the reported ranges always cover
+ * every changed byte.
+ *
+ * Passing `ranges` as NULL (or `max_ranges` as 0) selects the early-exit
+ * mode: the comparison stops at the first difference and 1 is returned.
+ *
+ * @param a Pointer to the first buffer (e.g. the previous snapshot)
+ * @param b Pointer to the second buffer (e.g. the current data)
+ * @param length Number of bytes to compare
+ * @param ranges Pointer to the output array of ranges, or NULL
+ * @param max_ranges Number of entries available in `ranges`
+ *
+ * @return Number of ranges written, or 1/0 for difference/no difference in
+ *         early-exit mode
+ */
+size_t my_memdiff(uint8_t * a, uint8_t * b, size_t length,
+                  mem_range_t * ranges, size_t max_ranges);
+
+/**
+ * @brief Reverses the order of bits inside each byte
+ *
+ * Mirrors every byte of the `length` byte block starting at `src` in place
+ * (bit 0 becomes bit 7 and so on), as needed for bit-reversed FFT ordering.
+ * Uses RBIT/REV on the Cortex-M4 and nibble-table shuffles on HOST.
+ *
+ * @param src Pointer to the memory block
+ * @param length Number of bytes to process
+ *
+ * @return Pointer to the source memory
+ */
+uint8_t * my_bitreverse(uint8_t * src, size_t length);
+
+/**
+ * @brief Counts the set bits in a block of memory
+ *
+ * Returns the total number of 1 bits in the `length` bytes starting at
+ * `src`.
+ *
+ * @param src Pointer to the memory block
+ * @param length Number of bytes to count
+ *
+ * @return Number of set bits
+ */
+size_t my_popcount(uint8_t * src, size_t length);
+
+/**
+ * @brief Builds a histogram of set bits per bit position
+ *
+ * For each bit position k (0 = least significant), stores in `counts[k]`
+ * the number of bytes among the `length` bytes at `src` that have bit k
+ * set. `counts` must hold 8 entries.
+ *
+ * @param src Pointer to the memory block
+ * @param length Number of bytes to process
+ * @param counts Pointer to the 8-entry output histogram
+ *
+ * @return void
+ */
+void my_bitcount_per_position(uint8_t * src, size_t length, size_t * counts);
+
 /**
  * @brief Allocates dynamic memory for word storage
  *
@@ -115,4 +239,116 @@ uint32_t * reserve_words(size_t length);
  */
 void free_words(uint32_t * src);
 
+/**
+ * @brief Initializes a lock-free block pool over caller storage
+ *
+ * Splits the `count * block_size` bytes at `buffer` into blocks and puts
+ * them all on the free list. No heap memory is used, so the storage can be
+ * a static array sized at compile time.
+ *
+ * @param pool Pointer to the pool to initialize
+ * @param buffer Pointer to word-aligned block storage
+ * @param block_size Size of one block in bytes (a multiple of 4)
+ * @param count Number of blocks (at most BLOCK_POOL_MAX_BLOCKS)
+ *
+ * @return Pointer to the pool, or NULL if the parameters are invalid
+ */
+block_pool_t * block_pool_init(block_pool_t * pool, uint8_t * buffer,
+                               size_t block_size, size_t count);
+
+/**
+ * @brief Takes a block from a block pool
+ *
+ * Runs in constant time without masking interrupts, so it may be called
+ * from both thread and interrupt context. On the Cortex-M4 the free list is
+ * updated with LDREX/STREX exclusives; on HOST with compare-and-swap.
+ *
+ * @param pool Pointer to the pool
+ *
+ * @return Pointer to the block, or NULL if the pool is exhausted
+ */
+uint8_t * block_alloc(block_pool_t * pool);
+
+/**
+ * @brief Returns a block to a block pool
+ *
+ * Safe to call from both thread and interrupt context.
+ *
+ * @param pool Pointer to the pool the block was taken from
+ * @param block Pointer to the block to return
+ *
+ * @return void
+ */
+void block_free(block_pool_t * pool, uint8_t * block);
+
+/**
+ * @brief Initializes an empty word vector
+ *
+ * The vector starts out using its inline storage, so no allocation is made
+ * until more than WORD_VECTOR_INLINE_W words are stored.
+ *
+ * @param vector Pointer to the vector to initialize
+ *
+ * @return void
+ */
+void word_vector_init(word_vector_t * vector);
+
+/**
+ * @brief Ensures a word vector can hold at least `capacity` words
+ *
+ * Grows the storage geometrically so that repeated appends run in
+ * amortized constant time. Existing contents are preserved.
+ *
+ * @param vector Pointer to the vector
+ * @param capacity Minimum number of words required
+ *
+ * @return Pointer to the vector data, or NULL if allocation fails
+ */
+uint32_t * word_vector_reserve(word_vector_t * vector, size_t capacity);
+
+/**
+ * @brief Appends a word to the end of a word vector
+ *
+ * @param vector Pointer to the vector
+ * @param value The word to append
+ *
+ * @return Pointer to the stored word, or NULL if allocation fails
+ */
+uint32_t * word_vector_push(word_vector_t * vector, uint32_t value);
+
+/**
+ * @brief Appends a block of words to the end of a word vector
+ *
+ * @param vector Pointer to the vector
+ * @param src Pointer to the words to append
+ * @param length Number of words to append
+ *
+ * @return Pointer to the first appended word, or NULL if allocation fails
+ */
+uint32_t * word_vector_append(word_vector_t * vector, uint32_t * src,
+                              size_t length);
+
+/**
+ * @brief Releases unused capacity of a word vector
+ *
+ * Moves the contents back to the inline storage when they fit, otherwise
+ * shrinks the allocation to the current size.
+ *
+ * @param vector Pointer to the vector
+ *
+ * @return Pointer to the vector data
+ */
+uint32_t * word_vector_shrink_to_fit(word_vector_t * vector);
+
+/**
+ * @brief Frees the storage of a word vector
+ *
+ * Leaves the vector empty and ready for reuse.
+ *
+ * @param vector Pointer to the vector
+ *
+ * @return void
+ */
+void word_vector_free(word_vector_t * vector);
+
 #endif /* __MEMORY_H__ */
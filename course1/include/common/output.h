@@ -0,0 +1,161 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are 
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material. 
+ *
+ *****************************************************************************/
+/**
+ * @file output.h
+ * @brief Buffered text output without printf
+ *
+ * This header file provides a small output layer that formats integers
+ * and copies literal text into a ring buffer, and hands the buffered bytes
+ * to a sink only when the buffer fills or output_flush() is called.
+ *
+ * On HOST the default sink writes to standard output with writev(). On
+ * the target there is no default sink and output is discarded, like
+ * PRINTF, until one is installed with output_set_sink().
+ *
+ * @author
+ * @date
+ *
+ */
+#ifndef __OUTPUT_H__
+#define __OUTPUT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Ring buffer size, a power of two */
+#if defined (MSP432)
+#define OUTPUT_BUFFER_SIZE (256)
+#else
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+#endif
+
+/* Formats for output_u8_array() */
+#define OUTPUT_U8_DEC (0)  /* "0 " to "255 " */
+#define OUTPUT_U8_HEX (1)  /* "00 " to "FF " */
+
+/**
+ * @brief Sink that receives buffered output
+ *
+ * Called with a contiguous run of buffered bytes. Returns the number of
+ * bytes it accepted, which may be fewer than `length`; returning 0 stops
+ * the current flush and leaves the rest buffered.
+ */
+typedef size_t (*output_sink_t)(uint8_t * data, size_t length);
+
+/**
+ * @brief Installs the sink used by output_flush()
+ *
+ * Passing NULL restores the platform default sink.
+ *
+ * @param sink The sink function, or NULL
+ *
+ * @return void
+ */
+void output_set_sink(output_sink_t sink);
+
+/**
+ * @brief Reserves contiguous space in the output buffer
+ *
+ * Returns a pointer to at least `length` writable bytes, flushing first
+ * if needed. The bytes are not output until output_commit() is called.
+ *
+ * @param length Number of bytes to reserve (at most OUTPUT_BUFFER_SIZE)
+ *
+ * @return Pointer to the reserved space, or NULL if it cannot be made
+ */
+uint8_t * output_reserve(size_t length);
+
+/**
+ * @brief Commits bytes written into space from output_reserve()
+ *
+ * @param length Number of bytes to commit (at most the reserved length)
+ *
+ * @return void
+ */
+void output_commit(size_t length);
+
+/**
+ * @brief Buffers a block of bytes for output
+ *
+ * Bytes that do not fit even after flushing (because the sink stopped
+ * accepting data) are dropped.
+ *
+ * @param data Pointer to the bytes to output
+ * @param length Number of bytes to output
+ *
+ * @return void
+ */
+void output_write(uint8_t * data, size_t length);
+
+/**
+ * @brief Buffers a null-terminated string for output
+ *
+ * @param str Pointer to the string, without its null terminator output
+ *
+ * @return void
+ */
+void output_string(uint8_t * str);
+
+/**
+ * @brief Buffers a single character for output
+ *
+ * @param c The character to output
+ *
+ * @return void
+ */
+void output_char(uint8_t c);
+
+/**
+ * @brief Formats an integer with my_itoa() straight into the buffer
+ *
+ * @param value The integer to output
+ * @param base The numeric base (as accepted by my_itoa())
+ *
+ * @return void
+ */
+void output_int(int32_t value, uint32_t base);
+
+/**
+ * @brief Formats a float with my_ftoa() straight into the buffer
+ *
+ * @param value The float to output
+ *
+ * @return void
+ */
+void output_float(float value);
+
+/**
+ * @brief Buffers a byte array as space-separated numbers
+ *
+ * Each byte is looked up in a static table of preformatted strings and
+ * copied into the buffer with one 4-byte store, so no digits are computed
+ * at run time. The buffer is filled a block at a time, giving one sink
+ * call per OUTPUT_BUFFER_SIZE bytes of text.
+ *
+ * @param array Pointer to the bytes to print
+ * @param length Number of bytes to print
+ * @param format OUTPUT_U8_DEC or OUTPUT_U8_HEX
+ *
+ * @return void
+ */
+void output_u8_array(uint8_t * array, size_t length, uint8_t format);
+
+/**
+ * @brief Hands all buffered bytes to the sink
+ *
+ * On HOST, pending stdio output is flushed first so text printed with
+ * PRINTF before the buffered bytes stays in order.
+ *
+ * @return Number of bytes still buffered (0 unless the sink stalled)
+ */
+size_t output_flush(void);
+
+#endif /* __OUTPUT_H__ */
@@ -16,13 +16,23 @@
 ******************************************************************************/
 #if defined (MSP432)
 #include "msp432p401r.h"
+#if defined (DEFERRED_LOG)
+#include "dlog.h"
+#define PRINTF(...) DLOG(__VA_ARGS__)
+#else
 #define PRINTF(...)
+#endif
 /******************************************************************************
  Platform - HOST
 ******************************************************************************/
 #elif defined (HOST)
 #include <stdio.h>
+#if defined (DEFERRED_LOG)
+#include "dlog.h"
+#define PRINTF(...) DLOG(__VA_ARGS__)
+#else
 #define PRINTF(...) printf(__VA_ARGS__)
+#endif
 /******************************************************************************
  Platform - Unsupported
 ******************************************************************************/
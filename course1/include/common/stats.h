@@ -22,11 +22,72 @@
 #ifndef __STATS_H__
 #define __STATS_H__
 
+#include <stdint.h>
+
+#define STATS_HISTOGRAM_BINS (256) /* One bin per unsigned char value */
+
+/* Everything compute_statistics() derives from one pass over the data */
+typedef struct {
+    unsigned char minimum;    /* Smallest value */
+    unsigned char maximum;    /* Largest value */
+    unsigned char mean;       /* Truncated mean, as find_mean() returns */
+    unsigned char median;     /* Median, as find_median() returns */
+    unsigned char mode;       /* Most frequent value, smallest on ties */
+    uint64_t length;          /* Number of values counted */
+    uint64_t sum;             /* Sum of all values */
+    float variance;           /* Population variance */
+    unsigned int histogram[STATS_HISTOGRAM_BINS]; /* Count of each value */
+} stats_result_t;
+
+/* Welford state is single precision on the Cortex-M4F FPU */
+#if defined (MSP432)
+typedef float stats_float_t;
+#else
+typedef double stats_float_t;
+#endif
+
+/* Running statistics of an unbounded stream, O(1) memory per stream */
+typedef struct {
+    uint64_t count;           /* Number of values pushed */
+    uint64_t sum;             /* Sum of all values */
+    stats_float_t mean;       /* Welford running mean */
+    stats_float_t m2;         /* Welford sum of squared deviations */
+    unsigned char minimum;    /* Smallest value, 255 while empty */
+    unsigned char maximum;    /* Largest value, 0 while empty */
+    unsigned int histogram[STATS_HISTOGRAM_BINS]; /* Count of each value */
+} stats_accumulator_t;
+
+#define STATS_WINDOW_MAX_CAPACITY (0xFFFF) /* Positions are 16-bit */
+
+/* Bytes of caller storage a window of `capacity` samples needs: two deques
+ * of 16-bit ring positions followed by the sample ring itself */
+#define STATS_WINDOW_BUFFER_SIZE(capacity) (5 * (capacity))
+
+/* Statistics over the last `capacity` samples of a stream */
+typedef struct {
+    uint16_t* min_deque;      /* Positions of rising candidate minima */
+    uint16_t* max_deque;      /* Positions of falling candidate maxima */
+    unsigned char* samples;   /* Ring of the samples in the window */
+    unsigned int capacity;    /* Number of samples the window spans */
+    unsigned int count;       /* Number of samples in the window */
+    unsigned int next;        /* Ring position of the next sample */
+    unsigned int min_head;    /* Deque index of the current minimum */
+    unsigned int min_length;  /* Entries in the minimum deque */
+    unsigned int max_head;    /* Deque index of the current maximum */
+    unsigned int max_length;  /* Entries in the maximum deque */
+    uint32_t sum;             /* Sum of the samples in the window */
+    unsigned int below;       /* Samples in the window below `cursor` */
+    unsigned char cursor;     /* Value of the lower middle sample */
+    unsigned int histogram[STATS_HISTOGRAM_BINS]; /* Count of each value */
+} stats_window_t;
+
 /**
  * @brief Prints the statistics of an array including minimum, maximum, mean, and median.
  *
  * This function takes an array and its length as inputs and prints the minimum,
- * maximum, mean, and median values of the array.
+ * maximum, mean, median and variance of the array. The values come from
+ * compute_statistics(), so the array is not modified; the mean and
+ * variance are printed unrounded with my_ftoa().
  *
  * @param array The array of unsigned characters.
  * @param length The length of the array.
@@ -35,6 +96,178 @@
  */
 void print_statistics(unsigned char* array, unsigned int length);
 
+/**
+ * @brief Computes all statistics of an array in one pass.
+ *
+ * This function takes an array and its length as inputs and fills `result`
+ * with the minimum, maximum, sum, mean, median, mode, variance and the full
+ * histogram. The array is read once to build the histogram and everything
+ * else is derived from the 256 bins, so the array is not modified and
+ * nothing is printed. A length of 0 gives all fields 0.
+ *
+ * @param array The array of unsigned characters.
+ * @param length The length of the array.
+ * @param result The structure to fill in.
+ *
+ * @return void
+ */
+void compute_statistics(unsigned char* array, unsigned int length,
+                        stats_result_t* result);
+
+/**
+ * @brief Resets a streaming statistics accumulator.
+ *
+ * @param acc The accumulator to reset.
+ *
+ * @return void
+ */
+void stats_accumulator_init(stats_accumulator_t* acc);
+
+/**
+ * @brief Adds one value to a streaming statistics accumulator.
+ *
+ * Updates the count, sum, minimum, maximum, histogram and the Welford mean
+ * and variance in constant time.
+ *
+ * @param acc The accumulator to update.
+ * @param value The new sample.
+ *
+ * @return void
+ */
+void stats_accumulator_push(stats_accumulator_t* acc, unsigned char value);
+
+/**
+ * @brief Adds a block of values to a streaming statistics accumulator.
+ *
+ * Equivalent to pushing each value, but the block's mean and variance are
+ * computed exactly with integers and combined into the running state
+ * once, so there is no per-value division.
+ *
+ * @param acc The accumulator to update.
+ * @param array The array of unsigned characters.
+ * @param length The length of the array.
+ *
+ * @return void
+ */
+void stats_accumulator_push_block(stats_accumulator_t* acc,
+                                  unsigned char* array, unsigned int length);
+
+/**
+ * @brief Merges one accumulator into another.
+ *
+ * Afterwards `acc` holds the statistics of both streams, as if every value
+ * pushed to `other` had been pushed to `acc`. Lets separate streams or
+ * interrupt contexts accumulate independently and combine later.
+ *
+ * @param acc The accumulator to merge into.
+ * @param other The accumulator to merge from; it is not changed.
+ *
+ * @return void
+ */
+void stats_accumulator_merge(stats_accumulator_t* acc,
+                             stats_accumulator_t* other);
+
+/**
+ * @brief Reports the statistics of everything pushed so far.
+ *
+ * Fills `result` as compute_statistics() would for the concatenation of
+ * all pushed values, with the variance taken from the Welford state. The
+ * accumulator is not changed and can keep receiving values. O(256).
+ *
+ * @param acc The accumulator to read.
+ * @param result The structure to fill in.
+ *
+ * @return void
+ */
+void stats_accumulator_snapshot(stats_accumulator_t* acc,
+                                stats_result_t* result);
+
+/**
+ * @brief Returns a percentile of everything pushed so far.
+ *
+ * Uses the nearest-rank definition: the smallest pushed value with at least
+ * `percent` percent of the values at or below it. 50 gives the lower
+ * middle value rather than the averaged median.
+ *
+ * @param acc The accumulator to read.
+ * @param percent The percentile, 0 to 100; larger values count as 100.
+ *
+ * @return The percentile value, or 0 if nothing has been pushed.
+ */
+unsigned char stats_accumulator_percentile(stats_accumulator_t* acc,
+                                           unsigned int percent);
+
+/**
+ * @brief Initializes an empty sliding window over caller storage.
+ *
+ * No heap memory is used, so the storage can be a static array sized at
+ * compile time with STATS_WINDOW_BUFFER_SIZE().
+ *
+ * @param window The window to initialize.
+ * @param buffer Pointer to STATS_WINDOW_BUFFER_SIZE(capacity) bytes,
+ *               at least 2-byte aligned.
+ * @param capacity Number of most recent samples the statistics cover
+ *                 (1 to STATS_WINDOW_MAX_CAPACITY).
+ *
+ * @return Pointer to the window, or NULL if the parameters are invalid.
+ */
+stats_window_t* stats_window_init(stats_window_t* window, uint8_t* buffer,
+                                  unsigned int capacity);
+
+/**
+ * @brief Adds a sample to a sliding window.
+ *
+ * Once the window is full the oldest sample drops out. The running sum and
+ * histogram are updated in constant time, the minimum and maximum deques
+ * in amortized constant time, and the median cursor moves at most to the
+ * next occupied histogram bin.
+ *
+ * @param window The window to update.
+ * @param value The new sample.
+ *
+ * @return void
+ */
+void stats_window_push(stats_window_t* window, unsigned char value);
+
+/**
+ * @brief Returns the smallest sample in a sliding window.
+ *
+ * @param window The window to read.
+ *
+ * @return The minimum, or 0 if the window is empty.
+ */
+unsigned char stats_window_minimum(stats_window_t* window);
+
+/**
+ * @brief Returns the largest sample in a sliding window.
+ *
+ * @param window The window to read.
+ *
+ * @return The maximum, or 0 if the window is empty.
+ */
+unsigned char stats_window_maximum(stats_window_t* window);
+
+/**
+ * @brief Returns the mean of a sliding window, truncated as find_mean() does.
+ *
+ * @param window The window to read.
+ *
+ * @return The mean, or 0 if the window is empty.
+ */
+unsigned char stats_window_mean(stats_window_t* window);
+
+/**
+ * @brief Returns the median of a sliding window.
+ *
+ * Gives the same value as find_median() over the samples in the window,
+ * averaging the two middle values for an even count.
+ *
+ * @param window The window to read.
+ *
+ * @return The median, or 0 if the window is empty.
+ */
+unsigned char stats_window_median(stats_window_t* window);
+
 /**
  * @brief Prints the array to the screen.
  *
@@ -48,6 +281,19 @@ void print_statistics(unsigned char* array, unsigned int length);
  */
 void print_array(unsigned char* array, unsigned int length);
 
+/**
+ * @brief Prints the array to the screen in hexadecimal.
+ *
+ * This function takes an array and its length as inputs and prints each element
+ * of the array as two hexadecimal digits.
+ *
+ * @param array The array of unsigned characters.
+ * @param length The length of the array.
+ *
+ * @return void
+ */
+void print_array_hex(unsigned char* array, unsigned int length);
+
 /**
  * @brief Finds the median value of the array.
  *
@@ -61,6 +307,74 @@ void print_array(unsigned char* array, unsigned int length);
  */
 unsigned char find_median(unsigned char* array, unsigned int length);
 
+/**
+ * @brief Finds the median value of the array without sorting it.
+ *
+ * This function takes an array and its length as inputs, counts the values
+ * into a 256-bin histogram in one pass, and walks the bins to the middle
+ * element. For an even length the two middle values are averaged the same
+ * way find_median() does. The array is not modified, and the time is O(n)
+ * for any input order.
+ *
+ * @param array The array of unsigned characters.
+ * @param length The length of the array.
+ *
+ * @return The median value of the array, or 0 if the length is 0.
+ */
+unsigned char find_median_histogram(unsigned char* array, unsigned int length);
+
+/**
+ * @brief Finds the k-th smallest value of the array.
+ *
+ * This function takes an array, its length and a 0-based ascending rank k,
+ * and returns the value that would be at index k if the array were sorted
+ * in ascending order. It uses introselect: quickselect with a
+ * median-of-medians fallback, so the time is O(n) for any input order.
+ * When `scratch` is not NULL the array is copied there first and left
+ * unchanged; otherwise it is reordered in place.
+ *
+ * @param array The array of unsigned characters.
+ * @param length The length of the array.
+ * @param k The rank to find, less than length.
+ * @param scratch Buffer of length elements, or NULL to work in place.
+ *
+ * @return The k-th smallest value, or 0 if k is out of range.
+ */
+unsigned char find_kth(unsigned char* array, unsigned int length,
+                       unsigned int k, unsigned char* scratch);
+
+/**
+ * @brief Finds the median value of the array without sorting it.
+ *
+ * This function takes an array and its length as inputs and returns the
+ * same median as find_median(), averaging the two middle values for an
+ * even length, using find_kth() style selection instead of a sort. When
+ * `scratch` is not NULL the array is left unchanged.
+ *
+ * @param array The array of unsigned characters.
+ * @param length The length of the array.
+ * @param scratch Buffer of length elements, or NULL to work in place.
+ *
+ * @return The median value of the array, or 0 if the length is 0.
+ */
+unsigned char find_median_nomutate(unsigned char* array, unsigned int length,
+                                   unsigned char* scratch);
+
+/**
+ * @brief Wider element variants of find_kth() and find_median_nomutate()
+ *
+ * Same behaviour for uint16_t and int32_t arrays, where a histogram is
+ * impractical. The even length median is computed without overflow.
+ */
+uint16_t find_kth_u16(uint16_t* array, unsigned int length, unsigned int k,
+                      uint16_t* scratch);
+int32_t find_kth_i32(int32_t* array, unsigned int length, unsigned int k,
+                     int32_t* scratch);
+uint16_t find_median_nomutate_u16(uint16_t* array, unsigned int length,
+                                  uint16_t* scratch);
+int32_t find_median_nomutate_i32(int32_t* array, unsigned int length,
+                                 int32_t* scratch);
+
 /**
  * @brief Finds the mean value of the array.
  *
@@ -11,10 +11,10 @@
 
 # Check the PLATFORM variable and assign files and include paths accordingly.
 ifeq ($(PLATFORM),HOST)
-	SOURCES = src/main.c src/memory.c src/stats.c src/data.c src/course1.c
+	SOURCES = src/main.c src/memory.c src/stats.c src/data.c src/output.c src/dlog.c src/course1.c
   	INCLUDES = -Iinclude/common
 else ifeq ($(PLATFORM),MSP432)
-	SOURCES := src/main.c src/memory.c src/stats.c src/data.c src/course1.c \
+	SOURCES := src/main.c src/memory.c src/stats.c src/data.c src/output.c src/dlog.c src/course1.c \
            src/interrupts_msp432p401r_gcc.c src/startup_msp432p401r_gcc.c \
            src/system_msp432p401r.c 
   	INCLUDES = -Iinclude/common -Iinclude/msp432 -Iinclude/CMSIS
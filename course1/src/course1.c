@@ -23,6 +23,8 @@
 #include "memory.h"
 #include "data.h"
 #include "stats.h"
+#include "output.h"
+#include "dlog.h"
 
 int8_t test_data1() {
   uint8_t * ptr;
@@ -82,6 +84,1049 @@ int8_t test_data2() {
   return TEST_NO_ERROR;
 }
 
+int8_t test_data64() {
+  uint8_t * ptr;
+  int64_t num = -1234567890123456789LL;
+  uint32_t digits;
+  int64_t value;
+  int64_t hex_value;
+  uint8_t overflow;
+
+  PRINTF("test_data64():\n");
+  ptr = (uint8_t*) reserve_words( DATA_SET_SIZE_W * 2 );
+
+  if (! ptr )
+  {
+    return TEST_ERROR;
+  }
+
+  digits = my_itoa64( num, ptr, BASE_10);
+  value = my_atoi64( ptr, digits, BASE_10, &overflow);
+  digits = my_itoa64( num, ptr, BASE_16);
+  hex_value = my_atoi64( ptr, digits, BASE_16, &overflow);
+  #ifdef VERBOSE
+  PRINTF("  Initial 64-bit number: %lld\n", (long long)num);
+  PRINTF("  Final 64-bit number: %lld\n", (long long)value);
+  #endif
+
+  /* One past INT64_MAX must saturate and report the overflow */
+  digits = my_itoa64( INT64_MAX, ptr, BASE_10);
+  ptr[digits - 2]++;
+  if ( my_atoi64( ptr, digits, BASE_10, &overflow) != INT64_MAX || !overflow )
+  {
+    value = 0;
+  }
+  free_words( (uint32_t*)ptr );
+
+  if ( value != num || hex_value != num )
+  {
+    return TEST_ERROR;
+  }
+  return TEST_NO_ERROR;
+}
+
+int8_t test_ftoa() {
+  uint8_t * ptr;
+  uint8_t * expected;
+  uint8_t length;
+  uint8_t i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_ftoa():\n");
+  ptr = (uint8_t*) reserve_words( DATA_SET_SIZE_W );
+
+  if (! ptr )
+  {
+    return TEST_ERROR;
+  }
+
+  length = my_ftoa( -12.375f, ptr);
+  expected = (uint8_t*) "-12.375";
+  for ( i = 0; i < length; i++ )
+  {
+    if ( ptr[i] != expected[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* On the upper rounding boundary, which an even significand accepts */
+  length = my_ftoa( 117760704.0f, ptr);
+  expected = (uint8_t*) "117760700";
+  for ( i = 0; i < length; i++ )
+  {
+    if ( ptr[i] != expected[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  length = my_ftoa( 1.5e-7f, ptr);
+  expected = (uint8_t*) "1.5e-7";
+  for ( i = 0; i < length; i++ )
+  {
+    if ( ptr[i] != expected[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* -0.75 in Q15 */
+  length = my_qtoa( FTOA_TEST_Q15, Q15_FRAC_BITS, 4, ptr);
+  expected = (uint8_t*) "-0.7500";
+  for ( i = 0; i < length; i++ )
+  {
+    if ( ptr[i] != expected[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  #ifdef VERBOSE
+  PRINTF("  Q15 %d: %s\n", FTOA_TEST_Q15, ptr);
+  #endif
+
+  free_words( (uint32_t*)ptr );
+  return ret;
+}
+
+/* Sink for test_output(): checks the digit pattern, a few bytes per call */
+static size_t output_test_count;
+static int8_t output_test_status;
+
+static size_t output_test_sink(uint8_t * data, size_t length)
+{
+  size_t i;
+
+  if ( length > OUTPUT_TEST_SINK_CHUNK )
+  {
+    length = OUTPUT_TEST_SINK_CHUNK;
+  }
+  for ( i = 0; i < length; i++ )
+  {
+    if ( data[i] != '0' + (output_test_count % 10) )
+    {
+      output_test_status = TEST_ERROR;
+    }
+    output_test_count++;
+  }
+  return length;
+}
+
+int8_t test_output() {
+  uint32_t i;
+  size_t pending;
+
+  PRINTF("test_output():\n");
+  output_test_count = 0;
+  output_test_status = TEST_NO_ERROR;
+  output_set_sink(output_test_sink);
+
+  /* Enough single digits to wrap the ring buffer several times */
+  for ( i = 0; i < OUTPUT_TEST_LENGTH / 10; i++ )
+  {
+    output_int(0, BASE_10);
+    output_string((uint8_t*) "12345678");
+    output_char('9');
+  }
+  pending = output_flush();
+  output_set_sink(NULL);
+
+  if ( pending != 0 || output_test_count != OUTPUT_TEST_LENGTH )
+  {
+    return TEST_ERROR;
+  }
+  return output_test_status;
+}
+
+/* Sink for test_print_table(): collects the text for comparison */
+static uint8_t print_table_text[PRINT_TABLE_TEXT_SIZE];
+static size_t print_table_length;
+
+static size_t print_table_sink(uint8_t * data, size_t length)
+{
+  size_t i;
+
+  for ( i = 0; i < length && print_table_length < PRINT_TABLE_TEXT_SIZE; i++ )
+  {
+    print_table_text[print_table_length++] = data[i];
+  }
+  return length;
+}
+
+int8_t test_print_table() {
+  uint8_t * set;
+  uint8_t * expected;
+  uint8_t * hex;
+  uint16_t i;
+  size_t length;
+  uint8_t digits;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_print_table():\n");
+  set = (uint8_t*) reserve_words( 256 / 4 );
+  expected = (uint8_t*) reserve_words( PRINT_TABLE_TEXT_SIZE / 4 );
+
+  if (! set || ! expected )
+  {
+    free_words( (uint32_t*)set );
+    free_words( (uint32_t*)expected );
+    return TEST_ERROR;
+  }
+
+  for ( i = 0; i < 256; i++ )
+  {
+    set[i] = (uint8_t) i;
+  }
+
+  /* Every byte value in decimal must match my_itoa() */
+  output_flush();
+  output_set_sink(print_table_sink);
+  print_table_length = 0;
+  output_u8_array(set, 256, OUTPUT_U8_DEC);
+  output_flush();
+  length = 0;
+  for ( i = 0; i < 256; i++ )
+  {
+    digits = my_itoa( set[i], expected + length, BASE_10);
+    length += digits - 1;
+    expected[length++] = ' ';
+  }
+  if ( print_table_length != length )
+  {
+    ret = TEST_ERROR;
+  }
+  for ( i = 0; i < length && i < print_table_length; i++ )
+  {
+    if ( print_table_text[i] != expected[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* And in hexadecimal as two digits each */
+  print_table_length = 0;
+  output_u8_array(set + 0xF9, 3, OUTPUT_U8_HEX);
+  output_flush();
+  hex = (uint8_t*) "F9 FA FB ";
+  for ( i = 0; i < 9; i++ )
+  {
+    if ( print_table_length != 9 || print_table_text[i] != hex[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* Statistics print the mean and variance unrounded */
+  print_table_length = 0;
+  print_statistics(set + 1, 4);
+  output_set_sink(NULL);
+  hex = (uint8_t*) "Statistics:\nMinimum: 1\nMaximum: 4\nMean: 2.5\n"
+                   "Median: 2\nVariance: 1.25\n";
+  for ( i = 0; hex[i]; i++ )
+  {
+    if ( i >= print_table_length || print_table_text[i] != hex[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  if ( print_table_length != i )
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (uint32_t*)set );
+  free_words( (uint32_t*)expected );
+  return ret;
+}
+
+int8_t test_codec() {
+  uint8_t * set;
+  uint8_t * text;
+  uint8_t * back;
+  uint8_t * expected;
+  size_t length;
+  uint8_t i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_codec():\n");
+  set = (uint8_t*) reserve_words( MEM_SET_SIZE_W );
+  text = (uint8_t*) reserve_words( HEXDUMP_LENGTH(MEM_SET_SIZE_B) / 4 + 1 );
+  back = (uint8_t*) reserve_words( MEM_SET_SIZE_W );
+
+  if (! set || ! text || ! back )
+  {
+    free_words( (uint32_t*)set );
+    free_words( (uint32_t*)text );
+    free_words( (uint32_t*)back );
+    return TEST_ERROR;
+  }
+
+  for ( i = 0; i < MEM_SET_SIZE_B; i++ )
+  {
+    set[i] = (uint8_t)(i * 37 + 11);
+  }
+
+  /* Hex and base64 must both round-trip */
+  length = hex_encode( set, MEM_SET_SIZE_B, text);
+  if ( length != HEX_ENCODED_LENGTH(MEM_SET_SIZE_B) || text[0] != '0' ||
+       text[1] != 'B' ||
+       hex_decode( text, length, back) != MEM_SET_SIZE_B )
+  {
+    ret = TEST_ERROR;
+  }
+  for ( i = 0; i < MEM_SET_SIZE_B; i++ )
+  {
+    if ( back[i] != set[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  length = base64_encode( set, MEM_SET_SIZE_B, text);
+  if ( length != BASE64_ENCODED_LENGTH(MEM_SET_SIZE_B) ||
+       base64_decode( text, length, back) != MEM_SET_SIZE_B )
+  {
+    ret = TEST_ERROR;
+  }
+  for ( i = 0; i < MEM_SET_SIZE_B; i++ )
+  {
+    if ( back[i] != set[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* A known vector, and a character outside the alphabet */
+  expected = (uint8_t*) "TWFu";
+  length = base64_encode( (uint8_t*) "Man", 3, text);
+  for ( i = 0; i < 4; i++ )
+  {
+    if ( length != 4 || text[i] != expected[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  if ( base64_decode( (uint8_t*) "TW-u", 4, back) != DATA_DECODE_ERROR )
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Padded groups write only their decoded bytes */
+  back[1] = 0xAA;
+  back[2] = 0xAA;
+  if ( base64_decode( (uint8_t*) "TQ==", 4, back) != 1 || back[0] != 'M' ||
+       back[1] != 0xAA ||
+       base64_decode( (uint8_t*) "TWE=", 4, back) != 2 || back[1] != 'a' ||
+       back[2] != 0xAA )
+  {
+    ret = TEST_ERROR;
+  }
+
+  length = hexdump( set, MEM_SET_SIZE_B, 0, text);
+  if ( length != HEXDUMP_LENGTH(MEM_SET_SIZE_B) || text[length - 1] != '\n' )
+  {
+    ret = TEST_ERROR;
+  }
+  #ifdef VERBOSE
+  text[length] = '\0';
+  PRINTF("%s", text);
+  #endif
+
+  free_words( (uint32_t*)set );
+  free_words( (uint32_t*)text );
+  free_words( (uint32_t*)back );
+  return ret;
+}
+
+int8_t test_varint() {
+  int32_t values[VARINT_TEST_COUNT] = { 0, -1, 1, -64, 64,
+                                        INT32_MAX, INT32_MIN, 300 };
+  int32_t decoded[VARINT_TEST_COUNT];
+  int64_t wide[2] = { INT64_MIN, -1234567890123LL };
+  int64_t wide_decoded[2];
+  uint8_t * buffer;
+  size_t length;
+  uint8_t i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_varint():\n");
+  length = varint_size32( values, VARINT_TEST_COUNT);
+  buffer = (uint8_t*) reserve_words( (length + 2 * VARINT64_MAX_BYTES) / 4 + 1 );
+
+  if (! buffer )
+  {
+    return TEST_ERROR;
+  }
+
+  /* 1+1+1+1+2+5+5+2 bytes: small magnitudes of either sign stay short */
+  if ( length != 18 ||
+       varint_encode32( values, VARINT_TEST_COUNT, buffer) != length ||
+       varint_decode32( buffer, length, decoded, VARINT_TEST_COUNT) !=
+       VARINT_TEST_COUNT )
+  {
+    ret = TEST_ERROR;
+  }
+  for ( i = 0; i < VARINT_TEST_COUNT; i++ )
+  {
+    if ( decoded[i] != values[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* A value cut off at the end of the input is reported */
+  if ( varint_decode32( buffer, length - 1, decoded, VARINT_TEST_COUNT) !=
+       DATA_DECODE_ERROR )
+  {
+    ret = TEST_ERROR;
+  }
+
+  length = varint_encode64( wide, 2, buffer);
+  if ( length != varint_size64( wide, 2) ||
+       varint_decode64( buffer, length, wide_decoded, 2) != 2 ||
+       wide_decoded[0] != wide[0] || wide_decoded[1] != wide[1] )
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (uint32_t*)buffer );
+  return ret;
+}
+
+int8_t test_data_bases() {
+  uint8_t generic[ITOA_MAX_SIZE];
+  uint8_t fixed[ITOA_MAX_SIZE];
+  int32_t nums[DATA_BASES_TEST_COUNT] = { 0, -1, 1234567, INT32_MIN, INT32_MAX };
+  uint32_t bases[4] = { 2, 8, 10, 16 };
+  uint8_t length;
+  uint8_t i;
+  uint8_t j;
+  uint8_t k;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_data_bases():\n");
+
+  /* The per-base variants must match the generic functions exactly */
+  for ( i = 0; i < DATA_BASES_TEST_COUNT; i++ )
+  {
+    for ( j = 0; j < 4; j++ )
+    {
+      length = (my_itoa)( nums[i], generic, bases[j]);
+      if ( bases[j] == 2 )
+      {
+        my_itoa( nums[i], fixed, 2);
+      }
+      else if ( bases[j] == 8 )
+      {
+        my_itoa( nums[i], fixed, 8);
+      }
+      else if ( bases[j] == 10 )
+      {
+        my_itoa( nums[i], fixed, BASE_10);
+      }
+      else
+      {
+        my_itoa( nums[i], fixed, BASE_16);
+      }
+      for ( k = 0; k < length; k++ )
+      {
+        if ( generic[k] != fixed[k] )
+        {
+          ret = TEST_ERROR;
+        }
+      }
+      if ( (my_atoi)( fixed, length, bases[j]) != nums[i] )
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    length = my_itoa( nums[i], fixed, BASE_10);
+    if ( my_atoi( fixed, length, BASE_10) != nums[i] )
+    {
+      ret = TEST_ERROR;
+    }
+    length = my_itoa( nums[i], fixed, BASE_16);
+    if ( my_atoi( fixed, length, BASE_16) != nums[i] )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  return ret;
+}
+
+int8_t test_itoa_len() {
+  uint8_t text[ITOA_MAX_SIZE];
+  int32_t nums[ITOA_LEN_TEST_COUNT] = { 0, 9, -10, 999999999, 1000000000,
+                                        -123456, INT32_MIN, INT32_MAX };
+  uint32_t bases[4] = { 2, 8, 10, 16 };
+  uint8_t * out;
+  size_t needed;
+  uint8_t i;
+  uint8_t j;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_itoa_len():\n");
+
+  /* The precomputed length must match what my_itoa() writes */
+  for ( i = 0; i < ITOA_LEN_TEST_COUNT; i++ )
+  {
+    for ( j = 0; j < 4; j++ )
+    {
+      if ( my_itoa_len( nums[i], bases[j]) !=
+           (my_itoa)( nums[i], text, bases[j]) - 1 )
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+
+  /* The array length must match my_itoa_array() for each base */
+  out = (uint8_t*)reserve_words( ITOA_LEN_TEST_COUNT * ITOA_MAX_CHARS / 4 );
+  if (! out )
+  {
+    return TEST_ERROR;
+  }
+  for ( j = 0; j < 4; j++ )
+  {
+    needed = my_itoa_array( nums, ITOA_LEN_TEST_COUNT, bases[j], ',', out,
+                            ITOA_LEN_TEST_COUNT * ITOA_MAX_CHARS);
+    if ( my_itoa_array_len( nums, ITOA_LEN_TEST_COUNT, bases[j], ',') !=
+         needed ||
+         my_itoa_array_len( nums, ITOA_LEN_TEST_COUNT, bases[j], '\0') !=
+         needed - (ITOA_LEN_TEST_COUNT - 1) )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* A short buffer still reports the full length */
+  if ( my_itoa_array( nums, ITOA_LEN_TEST_COUNT, BASE_10, ' ', out, 4) !=
+       my_itoa_array_len( nums, ITOA_LEN_TEST_COUNT, BASE_10, ' ') )
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (uint32_t*)out );
+  return ret;
+}
+
+/*
+ * Fills `length` bytes with `lo` plus a pseudo-random value below `span`,
+ * from a linear congruential generator started at `seed`. Returns the
+ * generator state so a caller can continue the sequence.
+ */
+static uint32_t fill_pseudo_random(uint8_t * buf, uint16_t length,
+                                   uint32_t seed, uint8_t lo, uint16_t span)
+{
+  uint16_t i;
+
+  for ( i = 0; i < length; i++ )
+  {
+    seed = seed * 1103515245 + 12345;
+    *(buf + i) = (uint8_t)(lo + (seed >> 16) % span);
+  }
+  return seed;
+}
+
+int8_t test_median_histogram() {
+  uint8_t * set;
+  uint8_t * copy;
+  uint16_t length;
+  uint16_t i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_median_histogram():\n");
+  set = (uint8_t*)reserve_words( STATS_TEST_LENGTH / 4 );
+  copy = (uint8_t*)reserve_words( STATS_TEST_LENGTH / 4 );
+
+  if (! set || ! copy )
+  {
+    free_words( (uint32_t*)set );
+    free_words( (uint32_t*)copy );
+    return TEST_ERROR;
+  }
+
+  fill_pseudo_random( set, STATS_TEST_LENGTH, STATS_TEST_SEED, 0, 256);
+
+  /* Odd and even lengths must match the sorting median */
+  for ( length = 1; length <= STATS_TEST_LENGTH; length += 13 )
+  {
+    my_memcopy( set, copy, length);
+    if ( find_median_histogram( set, length) != find_median( copy, length) )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  for ( length = 2; length <= STATS_TEST_LENGTH; length += 13 )
+  {
+    my_memcopy( set, copy, length);
+    if ( find_median_histogram( set, length) != find_median( copy, length) )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* The input must be unchanged: regenerate it and compare */
+  fill_pseudo_random( copy, STATS_TEST_LENGTH, STATS_TEST_SEED, 0, 256);
+  for ( i = 0; i < STATS_TEST_LENGTH; i++ )
+  {
+    if ( *(set + i) != *(copy + i) )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  free_words( (uint32_t*)set );
+  free_words( (uint32_t*)copy );
+  return ret;
+}
+
+int8_t test_compute_statistics() {
+  uint8_t * set;
+  uint8_t * copy;
+  stats_result_t * result;
+  uint32_t count;
+  uint32_t best;
+  uint16_t mode = 0;
+  float mean;
+  float variance;
+  uint16_t i;
+  uint16_t j;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_compute_statistics():\n");
+  set = (uint8_t*)reserve_words( STATS_TEST_LENGTH / 4 );
+  copy = (uint8_t*)reserve_words( STATS_TEST_LENGTH / 4 );
+  result = (stats_result_t*)reserve_words( sizeof(stats_result_t) / 4 + 1 );
+
+  if (! set || ! copy || ! result )
+  {
+    free_words( (uint32_t*)set );
+    free_words( (uint32_t*)copy );
+    free_words( (uint32_t*)result );
+    return TEST_ERROR;
+  }
+
+  /* Values from a narrow range so the mode is well defined */
+  fill_pseudo_random( set, STATS_TEST_LENGTH, STATS_TEST_SEED, 100, 41);
+  my_memcopy( set, copy, STATS_TEST_LENGTH);
+  compute_statistics( set, STATS_TEST_LENGTH, result);
+
+  /* Each field must match the separate find_ functions */
+  if ( result->length != STATS_TEST_LENGTH ||
+       result->minimum != find_minimum( copy, STATS_TEST_LENGTH) ||
+       result->maximum != find_maximum( copy, STATS_TEST_LENGTH) ||
+       result->mean != find_mean( copy, STATS_TEST_LENGTH) ||
+       result->median != find_median( copy, STATS_TEST_LENGTH) )
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Mode, sum and variance against a direct count over the data */
+  best = 0;
+  mean = (float)result->sum / STATS_TEST_LENGTH;
+  variance = 0.0f;
+  for ( i = 0; i < STATS_HISTOGRAM_BINS; i++ )
+  {
+    count = 0;
+    for ( j = 0; j < STATS_TEST_LENGTH; j++ )
+    {
+      count += ( *(set + j) == i );
+    }
+    if ( count != *(result->histogram + i) )
+    {
+      ret = TEST_ERROR;
+    }
+    if ( count > best )
+    {
+      best = count;
+      mode = i;
+    }
+  }
+  if ( result->mode != mode )
+  {
+    ret = TEST_ERROR;
+  }
+  count = 0;
+  for ( j = 0; j < STATS_TEST_LENGTH; j++ )
+  {
+    count += *(set + j);
+    variance += ((float)*(set + j) - mean) * ((float)*(set + j) - mean);
+  }
+  variance /= STATS_TEST_LENGTH;
+  if ( result->sum != count || result->variance < variance - 0.01f ||
+       result->variance > variance + 0.01f )
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* The input must be unchanged */
+  fill_pseudo_random( copy, STATS_TEST_LENGTH, STATS_TEST_SEED, 100, 41);
+  for ( i = 0; i < STATS_TEST_LENGTH; i++ )
+  {
+    if ( *(set + i) != *(copy + i) )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  compute_statistics( set, 0, result);
+  if ( result->length != 0 || result->sum != 0 || result->maximum != 0 )
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (uint32_t*)set );
+  free_words( (uint32_t*)copy );
+  free_words( (uint32_t*)result );
+  return ret;
+}
+
+int8_t test_stats_simd() {
+  uint8_t * set;
+  uint8_t * start;
+  uint32_t seed = STATS_TEST_SEED;
+  uint32_t sum;
+  uint8_t min;
+  uint8_t max;
+  uint16_t length;
+  uint16_t offset;
+  uint16_t i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_stats_simd():\n");
+  set = (uint8_t*)reserve_words( (STATS_TEST_LENGTH + 4) / 4 );
+
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  /* Every tail length and start alignment against a plain loop */
+  for ( offset = 0; offset < 4; offset++ )
+  {
+    start = set + offset;
+    for ( length = 1; length <= STATS_TEST_LENGTH; length += 7 )
+    {
+      seed = fill_pseudo_random( start, length, seed, 10, 200);
+      min = *start;
+      max = *start;
+      sum = 0;
+      for ( i = 0; i < length; i++ )
+      {
+        min = ( *(start + i) < min ) ? *(start + i) : min;
+        max = ( *(start + i) > max ) ? *(start + i) : max;
+        sum += *(start + i);
+      }
+      if ( find_minimum( start, length) != min ||
+           find_maximum( start, length) != max ||
+           find_mean( start, length) != sum / length )
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+
+  /* Extremes in the scalar tail and at either end */
+  for ( i = 0; i < STATS_TEST_LENGTH; i++ )
+  {
+    *(set + i) = 128;
+  }
+  *(set + STATS_TEST_LENGTH - 1) = 0;
+  *set = 255;
+  if ( find_minimum( set, STATS_TEST_LENGTH) != 0 ||
+       find_maximum( set, STATS_TEST_LENGTH) != 255 )
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (uint32_t*)set );
+  return ret;
+}
+
+int8_t test_find_kth() {
+  int32_t * set;
+  int32_t * scratch;
+  int32_t * sorted;
+  uint16_t wide[5] = { 60000, 2, 60000, 7, 1 };
+  uint16_t wide_scratch[5];
+  int32_t value;
+  uint16_t i;
+  uint16_t j;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_find_kth():\n");
+  set = (int32_t*)reserve_words( KTH_TEST_LENGTH );
+  scratch = (int32_t*)reserve_words( KTH_TEST_LENGTH );
+  sorted = (int32_t*)reserve_words( KTH_TEST_LENGTH );
+
+  if (! set || ! scratch || ! sorted )
+  {
+    free_words( (uint32_t*)set );
+    free_words( (uint32_t*)scratch );
+    free_words( (uint32_t*)sorted );
+    return TEST_ERROR;
+  }
+
+  /* Signed values with repeats, and an insertion sorted reference */
+  fill_pseudo_random( (uint8_t*)scratch, KTH_TEST_LENGTH, STATS_TEST_SEED,
+                      0, 64);
+  for ( i = 0; i < KTH_TEST_LENGTH; i++ )
+  {
+    value = (int32_t)*((uint8_t*)scratch + i) - 32;
+    *(set + i) = value;
+    for ( j = i; j > 0 && *(sorted + j - 1) > value; j-- )
+    {
+      *(sorted + j) = *(sorted + j - 1);
+    }
+    *(sorted + j) = value;
+  }
+
+  /* Every rank, with the input left in place */
+  for ( i = 0; i < KTH_TEST_LENGTH; i++ )
+  {
+    if ( find_kth_i32( set, KTH_TEST_LENGTH, i, scratch) != *(sorted + i) )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  fill_pseudo_random( (uint8_t*)scratch, KTH_TEST_LENGTH, STATS_TEST_SEED,
+                      0, 64);
+  for ( i = 0; i < KTH_TEST_LENGTH; i++ )
+  {
+    if ( *(set + i) != (int32_t)*((uint8_t*)scratch + i) - 32 )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* Even and odd length medians, the odd one in place */
+  value = (*(sorted + KTH_TEST_LENGTH / 2 - 1) +
+           *(sorted + KTH_TEST_LENGTH / 2)) / 2;
+  if ( find_median_nomutate_i32( set, KTH_TEST_LENGTH, scratch) != value )
+  {
+    ret = TEST_ERROR;
+  }
+  value = find_kth_i32( set, KTH_TEST_LENGTH - 1, KTH_TEST_LENGTH / 2 - 1,
+                        scratch);
+  if ( find_median_nomutate_i32( set, KTH_TEST_LENGTH - 1, NULL) != value )
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* The even median of wide values must not overflow */
+  if ( find_median_nomutate_u16( wide, 4, wide_scratch) != 30003 ||
+       find_kth_u16( wide, 5, 4, wide_scratch) != 60000 ||
+       find_kth_u16( wide, 5, 5, wide_scratch) != 0 )
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (uint32_t*)set );
+  free_words( (uint32_t*)scratch );
+  free_words( (uint32_t*)sorted );
+  return ret;
+}
+
+int8_t test_stats_accumulator() {
+  uint8_t * set;
+  stats_accumulator_t * first;
+  stats_accumulator_t * second;
+  stats_result_t * expected;
+  stats_result_t * result;
+  uint16_t i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_stats_accumulator():\n");
+  set = (uint8_t*)reserve_words( STATS_TEST_LENGTH / 4 );
+  first = (stats_accumulator_t*)
+          reserve_words( sizeof(stats_accumulator_t) / 4 );
+  second = (stats_accumulator_t*)
+           reserve_words( sizeof(stats_accumulator_t) / 4 );
+  expected = (stats_result_t*)reserve_words( sizeof(stats_result_t) / 4 );
+  result = (stats_result_t*)reserve_words( sizeof(stats_result_t) / 4 );
+
+  if (! set || ! first || ! second || ! expected || ! result )
+  {
+    ret = TEST_ERROR;
+  }
+  else
+  {
+    fill_pseudo_random( set, STATS_TEST_LENGTH, STATS_TEST_SEED, 50, 101);
+
+    /* One stream value by value, the other as a block, then merged */
+    stats_accumulator_init( first );
+    stats_accumulator_init( second );
+    for ( i = 0; i < STATS_TEST_LENGTH / 3; i++ )
+    {
+      stats_accumulator_push( first, *(set + i) );
+    }
+    stats_accumulator_push_block( second, set + STATS_TEST_LENGTH / 3,
+                                  STATS_TEST_LENGTH - STATS_TEST_LENGTH / 3);
+    stats_accumulator_merge( first, second );
+
+    /* The snapshot must match a whole-array compute_statistics() */
+    stats_accumulator_snapshot( first, result );
+    compute_statistics( set, STATS_TEST_LENGTH, expected );
+    if ( result->length != expected->length ||
+         result->sum != expected->sum ||
+         result->minimum != expected->minimum ||
+         result->maximum != expected->maximum ||
+         result->mean != expected->mean ||
+         result->median != expected->median ||
+         result->mode != expected->mode ||
+         result->variance < expected->variance * 0.999f ||
+         result->variance > expected->variance * 1.001f )
+    {
+      ret = TEST_ERROR;
+    }
+    for ( i = 0; i < STATS_HISTOGRAM_BINS; i++ )
+    {
+      if ( *(result->histogram + i) != *(expected->histogram + i) )
+      {
+        ret = TEST_ERROR;
+      }
+    }
+
+    /* Percentiles at the ends are the extremes */
+    if ( stats_accumulator_percentile( first, 0) != expected->minimum ||
+         stats_accumulator_percentile( first, 100) != expected->maximum ||
+         stats_accumulator_percentile( first, 50) !=
+         find_kth( set, STATS_TEST_LENGTH, STATS_TEST_LENGTH / 2 - 1, NULL) )
+    {
+      ret = TEST_ERROR;
+    }
+
+    /* An empty accumulator reports zeros */
+    stats_accumulator_init( second );
+    stats_accumulator_snapshot( second, result );
+    if ( result->length != 0 || stats_accumulator_percentile( second, 50) )
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  free_words( (uint32_t*)set );
+  free_words( (uint32_t*)first );
+  free_words( (uint32_t*)second );
+  free_words( (uint32_t*)expected );
+  free_words( (uint32_t*)result );
+  return ret;
+}
+
+int8_t test_stats_window() {
+  uint8_t * set;
+  uint8_t * scratch;
+  uint8_t * buffer;
+  stats_window_t * window;
+  uint16_t count;
+  uint16_t i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_stats_window():\n");
+  set = (uint8_t*)reserve_words( STATS_TEST_LENGTH / 4 );
+  scratch = (uint8_t*)reserve_words( WINDOW_TEST_CAPACITY / 4 );
+  buffer = (uint8_t*)
+           reserve_words( STATS_WINDOW_BUFFER_SIZE(WINDOW_TEST_CAPACITY) / 4 );
+  window = (stats_window_t*)reserve_words( sizeof(stats_window_t) / 4 );
+
+  if (! set || ! scratch || ! buffer || ! window ||
+      stats_window_init( window, buffer, WINDOW_TEST_CAPACITY) != window ||
+      stats_window_init( window, buffer, 0) != NULL )
+  {
+    ret = TEST_ERROR;
+  }
+  else
+  {
+    /* A slow drift with noise, so minima and maxima age out */
+    fill_pseudo_random( set, STATS_TEST_LENGTH, STATS_TEST_SEED, 0, 32);
+    for ( i = 0; i < STATS_TEST_LENGTH; i++ )
+    {
+      *(set + i) += i / 2;
+    }
+    stats_window_init( window, buffer, WINDOW_TEST_CAPACITY);
+
+    /* After every sample, compare with the array functions on the
+     * samples the window covers */
+    for ( i = 0; i < STATS_TEST_LENGTH; i++ )
+    {
+      stats_window_push( window, *(set + i) );
+      count = ( i + 1 < WINDOW_TEST_CAPACITY ) ? i + 1 : WINDOW_TEST_CAPACITY;
+      if ( stats_window_minimum( window ) !=
+           find_minimum( set + i + 1 - count, count) ||
+           stats_window_maximum( window ) !=
+           find_maximum( set + i + 1 - count, count) ||
+           stats_window_mean( window ) !=
+           find_mean( set + i + 1 - count, count) ||
+           stats_window_median( window ) !=
+           find_median_nomutate( set + i + 1 - count, count, scratch) )
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+
+  free_words( (uint32_t*)set );
+  free_words( (uint32_t*)scratch );
+  free_words( (uint32_t*)buffer );
+  free_words( (uint32_t*)window );
+  return ret;
+}
+
+int8_t test_dlog() {
+  uint32_t * words;
+  uint32_t dropped;
+  size_t count;
+  size_t total;
+  uint16_t i;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_dlog():\n");
+  words = reserve_words( DLOG_TEST_WORDS );
+
+  if (! words )
+  {
+    return TEST_ERROR;
+  }
+
+  /* Start from an empty ring; earlier records are sent on as usual */
+  dlog_flush(NULL);
+
+  DLOG("  dlog %d %x\n", -5, 0xBEEF);
+  DLOG("  dlog no arguments\n");
+  count = dlog_read(words, DLOG_TEST_WORDS);
+  if ( count != 4 ||
+       DLOG_HEADER_COUNT(words[0]) != 2 || (int32_t)words[1] != -5 ||
+       words[2] != 0xBEEF || DLOG_HEADER_COUNT(words[3]) != 0 ||
+       DLOG_HEADER_ID(words[0]) == DLOG_HEADER_ID(words[3]) )
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Two words per record: only half of these fit, the rest are dropped */
+  dropped = dlog_dropped();
+  for ( i = 0; i < DLOG_BUFFER_WORDS; i++ )
+  {
+    DLOG("  dlog fill %u\n", i);
+  }
+  total = 0;
+  while ( (count = dlog_read(words, DLOG_TEST_WORDS)) > 0 )
+  {
+    if ( words[1] != total / 2 )
+    {
+      ret = TEST_ERROR;
+    }
+    total += count;
+  }
+  if ( total != DLOG_BUFFER_WORDS ||
+       dlog_dropped() - dropped != DLOG_BUFFER_WORDS / 2 )
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( words );
+  return ret;
+}
+
 int8_t test_memmove1() {
   uint8_t i;
   int8_t ret = TEST_NO_ERROR;
@@ -285,6 +1330,82 @@ int8_t test_memset()
   return ret;
 }
 
+/* Source minus destination offsets for test_mem_small(): dst after src, same, before */
+static const int8_t mem_small_shifts[MEM_SMALL_SHIFT_COUNT] = { -9, -1, 0, 1, 9 };
+
+int8_t test_mem_small()
+{
+  uint8_t * set;
+  uint8_t * src;
+  uint8_t * dst;
+  size_t length;
+  uint8_t s;
+  uint8_t i;
+  uint8_t expected;
+  int8_t ret = TEST_NO_ERROR;
+
+  PRINTF("test_mem_small():\n");
+  set = (uint8_t*) reserve_words( MEM_SMALL_SIZE_B / 4 );
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+  dst = set + MEM_SMALL_GUARD;
+
+  /* Every short length, in both overlap directions and in place */
+  for ( length = 0; length <= MEM_SMALL_MAX_LENGTH; length++ )
+  {
+    for ( s = 0; s < MEM_SMALL_SHIFT_COUNT; s++ )
+    {
+      for ( i = 0; i < MEM_SMALL_SIZE_B; i++ )
+      {
+        *(set + i) = i;
+      }
+      src = dst + mem_small_shifts[s];
+      my_memmove(src, dst, length);
+      for ( i = 0; i < MEM_SMALL_SIZE_B; i++ )
+      {
+        expected = i;
+        if ( i >= MEM_SMALL_GUARD && i < MEM_SMALL_GUARD + length )
+        {
+          expected = i + mem_small_shifts[s];
+        }
+        if ( *(set + i) != expected )
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+
+    /* my_memset() and my_memzero() must stop exactly at length */
+    for ( i = 0; i < MEM_SMALL_SIZE_B; i++ )
+    {
+      *(set + i) = i;
+    }
+    my_memset(dst, length, 0xA5);
+    for ( i = 0; i < MEM_SMALL_SIZE_B; i++ )
+    {
+      expected = ( i >= MEM_SMALL_GUARD && i < MEM_SMALL_GUARD + length ) ? 0xA5 : i;
+      if ( *(set + i) != expected )
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    my_memzero(dst, length);
+    for ( i = 0; i < MEM_SMALL_SIZE_B; i++ )
+    {
+      expected = ( i >= MEM_SMALL_GUARD && i < MEM_SMALL_GUARD + length ) ? 0 : i;
+      if ( *(set + i) != expected )
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+
+  free_words( (uint32_t*)set );
+  return ret;
+}
+
 int8_t test_reverse()
 {
   uint8_t i;
@@ -321,6 +1442,381 @@ int8_t test_reverse()
   return ret;
 }
 
+int8_t test_memdiff()
+{
+  uint8_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint8_t * ptra;
+  uint8_t * ptrb;
+  mem_range_t ranges[MEMDIFF_MAX_RANGES];
+  size_t count;
+
+  PRINTF("test_memdiff()\n");
+  set = (uint8_t*)reserve_words(MEM_SET_SIZE_W * 2);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+  ptra = &set[0];
+  ptrb = &set[MEM_SET_SIZE_B];
+
+  /* Initialize both halves to the same values */
+  for( i = 0; i < MEM_SET_SIZE_B; i++)
+  {
+    ptra[i] = i;
+    ptrb[i] = i;
+  }
+
+  if (my_memdiff(ptra, ptrb, MEM_SET_SIZE_B, NULL, 0) != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Change [3, 6), [20, 21) and [31, 32) */
+  ptrb[3] = ptrb[4] = ptrb[5] = 0xAA;
+  ptrb[20] = 0xAA;
+  ptrb[31] = 0xAA;
+
+  count = my_memdiff(ptra, ptrb, MEM_SET_SIZE_B, ranges, MEMDIFF_MAX_RANGES);
+  if (count != 3 ||
+      ranges[0].offset != 3  || ranges[0].length != 3 ||
+      ranges[1].offset != 20 || ranges[1].length != 1 ||
+      ranges[2].offset != 31 || ranges[2].length != 1)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Too few ranges: the last one must cover the remaining differences */
+  count = my_memdiff(ptra, ptrb, MEM_SET_SIZE_B, ranges, 2);
+  if (count != 2 || ranges[1].offset != 20 || ranges[1].length != 12)
+  {
+    ret = TEST_ERROR;
+  }
+
+  if (my_memdiff(ptra, ptrb, MEM_SET_SIZE_B, NULL, 0) != 1)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (uint32_t*)set );
+  return ret;
+}
+
+int8_t test_bitops()
+{
+  uint8_t i;
+  uint8_t k;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  size_t bits = 0;
+  size_t expected[8] = {0};
+  size_t counts[8];
+
+  PRINTF("test_bitops()\n");
+  set = (uint8_t*)reserve_words(MEM_SET_SIZE_W);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  /* Initialize the set to test values and count the bits by hand */
+  for( i = 0; i < MEM_SET_SIZE_B; i++)
+  {
+    set[i] = i * 7;
+    for (k = 0; k < 8; k++)
+    {
+      bits += (set[i] >> k) & 1;
+      expected[k] += (set[i] >> k) & 1;
+    }
+  }
+
+  if (my_popcount(set, MEM_SET_SIZE_B) != bits)
+  {
+    ret = TEST_ERROR;
+  }
+
+  my_bitcount_per_position(set, MEM_SET_SIZE_B, counts);
+  for (k = 0; k < 8; k++)
+  {
+    if (counts[k] != expected[k])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  print_array(set, MEM_SET_SIZE_B);
+  my_bitreverse(set, MEM_SET_SIZE_B);
+  print_array(set, MEM_SET_SIZE_B);
+
+  /* 7 * 1 = 0x07 reverses to 0xE0, and reversing twice restores the data */
+  if (set[1] != 0xE0)
+  {
+    ret = TEST_ERROR;
+  }
+  my_bitreverse(set, MEM_SET_SIZE_B);
+  for (i = 0; i < MEM_SET_SIZE_B; i++)
+  {
+    if (set[i] != (uint8_t)(i * 7))
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  free_words( (uint32_t*)set );
+  return ret;
+}
+
+int8_t test_word_vector()
+{
+  uint32_t i;
+  int8_t ret = TEST_NO_ERROR;
+  word_vector_t vector;
+#ifdef HOST
+  uint32_t * block;
+#endif
+
+  PRINTF("test_word_vector()\n");
+  word_vector_init(&vector);
+
+  /* Small contents must stay in the inline storage */
+  for (i = 0; i < WORD_VECTOR_INLINE_W; i++)
+  {
+    word_vector_push(&vector, i);
+  }
+  if (vector.data != vector.inline_words)
+  {
+    ret = TEST_ERROR;
+  }
+
+  for (i = WORD_VECTOR_INLINE_W; i < WORD_VECTOR_TEST_LENGTH; i++)
+  {
+    if (! word_vector_push(&vector, i))
+    {
+      word_vector_free(&vector);
+      return TEST_ERROR;
+    }
+  }
+  word_vector_shrink_to_fit(&vector);
+
+  if (vector.size != WORD_VECTOR_TEST_LENGTH || vector.capacity < vector.size)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < WORD_VECTOR_TEST_LENGTH; i++)
+  {
+    if (vector.data[i] != i)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  word_vector_free(&vector);
+
+#ifdef HOST
+  /* Past WORD_VECTOR_MAP_THRESHOLD_B the storage moves to its own
+   * mapping and grows and shrinks there */
+  block = reserve_words(WORD_VECTOR_TEST_LENGTH);
+  word_vector_init(&vector);
+  for (i = 0; ret == TEST_NO_ERROR && i < WORD_VECTOR_MAP_TEST_LENGTH; i++)
+  {
+    if (! word_vector_push(&vector, i))
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  for (i = 0; ret == TEST_NO_ERROR && i < WORD_VECTOR_MAP_TEST_LENGTH; i++)
+  {
+    if (vector.data[i] != i)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* The length is a whole number of pages, so nothing is left over */
+  word_vector_shrink_to_fit(&vector);
+  if (vector.size != WORD_VECTOR_MAP_TEST_LENGTH ||
+      vector.capacity != WORD_VECTOR_MAP_TEST_LENGTH)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; ret == TEST_NO_ERROR && i < WORD_VECTOR_MAP_TEST_LENGTH; i++)
+  {
+    if (vector.data[i] != i)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* Appending to the exactly full mapping must grow it again */
+  if (! block)
+  {
+    ret = TEST_ERROR;
+  }
+  else
+  {
+    for (i = 0; i < WORD_VECTOR_TEST_LENGTH; i++)
+    {
+      block[i] = WORD_VECTOR_MAP_TEST_LENGTH + i;
+    }
+    if (! word_vector_append(&vector, block, WORD_VECTOR_TEST_LENGTH) ||
+        vector.size != WORD_VECTOR_MAP_TEST_LENGTH + WORD_VECTOR_TEST_LENGTH)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  for (i = 0; ret == TEST_NO_ERROR && i < vector.size; i++)
+  {
+    if (vector.data[i] != i)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  free_words(block);
+  word_vector_free(&vector);
+#endif
+  return ret;
+}
+
+int8_t test_block_pool()
+{
+  uint8_t i;
+  uint8_t j;
+  int8_t ret = TEST_NO_ERROR;
+  uint32_t storage[BLOCK_POOL_TEST_COUNT * BLOCK_POOL_TEST_SIZE_W];
+  uint8_t * blocks[BLOCK_POOL_TEST_COUNT];
+  block_pool_t pool;
+
+  PRINTF("test_block_pool()\n");
+  if (! block_pool_init(&pool, (uint8_t*)storage,
+                        BLOCK_POOL_TEST_SIZE_W * sizeof(uint32_t),
+                        BLOCK_POOL_TEST_COUNT))
+  {
+    return TEST_ERROR;
+  }
+
+  /* Every block must be handed out exactly once */
+  for (i = 0; i < BLOCK_POOL_TEST_COUNT; i++)
+  {
+    blocks[i] = block_alloc(&pool);
+    if (! blocks[i] )
+    {
+      return TEST_ERROR;
+    }
+    for (j = 0; j < i; j++)
+    {
+      if (blocks[j] == blocks[i])
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+  if (block_alloc(&pool) != NULL)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* A freed block is the next one handed out */
+  block_free(&pool, blocks[2]);
+  if (block_alloc(&pool) != blocks[2])
+  {
+    ret = TEST_ERROR;
+  }
+
+  return ret;
+}
+
+int8_t test_itoa_array()
+{
+  uint8_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * ptr;
+  int32_t values[ITOA_ARRAY_TEST_COUNT] = {0, -4096, 123456, 7, -1};
+  const char * expected = "0,-4096,123456,7,-1";
+  size_t length;
+
+  PRINTF("test_itoa_array()\n");
+  ptr = (uint8_t*) reserve_words( DATA_SET_SIZE_W );
+  if (! ptr )
+  {
+    return TEST_ERROR;
+  }
+
+  length = my_itoa_array(values, ITOA_ARRAY_TEST_COUNT, BASE_10, ',',
+                         ptr, DATA_SET_SIZE_W * sizeof(uint32_t));
+  if (length != 19)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < length && ret == TEST_NO_ERROR; i++)
+  {
+    if (ptr[i] != (uint8_t)expected[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* Too small: only "0,-4096" fits, but the full length is still reported */
+  ptr[7] = 0xFF;
+  if (my_itoa_array(values, ITOA_ARRAY_TEST_COUNT, BASE_10, ',', ptr, 10)
+      != length || ptr[7] != 0xFF)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (uint32_t*)ptr );
+  return ret;
+}
+
+int8_t test_atoi_stream()
+{
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t chunk1[] = "12, 2";
+  uint8_t chunk2[] = "50\n300 -4,";
+  uint8_t chunk3[] = "7";
+  uint8_t wide[] = "4294967296 4294967551,00000000000000000042 -4294967296";
+  uint8_t wide_hex[] = "1000000FF";
+  uint8_t values[ATOI_STREAM_TEST_COUNT];
+  atoi_stream_t stream;
+
+  PRINTF("test_atoi_stream()\n");
+  atoi_stream_init(&stream, BASE_10);
+  atoi_stream_output_u8(&stream, values, ATOI_STREAM_TEST_COUNT);
+
+  /* "250" is split across the first two chunks */
+  atoi_stream_feed(&stream, chunk1, sizeof(chunk1) - 1);
+  atoi_stream_feed(&stream, chunk2, sizeof(chunk2) - 1);
+  atoi_stream_feed(&stream, chunk3, sizeof(chunk3) - 1);
+
+  /* Values are clamped to the uint8 range */
+  if (atoi_stream_finish(&stream) != ATOI_STREAM_TEST_COUNT ||
+      values[0] != 12 || values[1] != 250 || values[2] != 255 ||
+      values[3] != 0 || values[4] != 7)
+  {
+    ret = TEST_ERROR;
+  }
+  print_array(values, ATOI_STREAM_TEST_COUNT);
+
+  /* Magnitudes past 32 bits still clamp, rather than wrap to 0 and 255 */
+  atoi_stream_init(&stream, BASE_10);
+  atoi_stream_output_u8(&stream, values, ATOI_STREAM_TEST_COUNT);
+  atoi_stream_feed(&stream, wide, sizeof(wide) - 1);
+  if (atoi_stream_finish(&stream) != 4 || values[0] != 255 ||
+      values[1] != 255 || values[2] != 42 || values[3] != 0)
+  {
+    ret = TEST_ERROR;
+  }
+  atoi_stream_init(&stream, BASE_16);
+  atoi_stream_output_u8(&stream, values, ATOI_STREAM_TEST_COUNT);
+  atoi_stream_feed(&stream, wide_hex, sizeof(wide_hex) - 1);
+  if (atoi_stream_finish(&stream) != 1 || values[0] != 255)
+  {
+    ret = TEST_ERROR;
+  }
+
+  return ret;
+}
+
 void course1(void) 
 {
   uint8_t i;
@@ -335,6 +1831,28 @@ void course1(void)
   results[5] = test_memcopy();
   results[6] = test_memset();
   results[7] = test_reverse();
+  results[8] = test_memdiff();
+  results[9] = test_bitops();
+  results[10] = test_word_vector();
+  results[11] = test_block_pool();
+  results[12] = test_itoa_array();
+  results[13] = test_atoi_stream();
+  results[14] = test_data64();
+  results[15] = test_ftoa();
+  results[16] = test_output();
+  results[17] = test_dlog();
+  results[18] = test_print_table();
+  results[19] = test_codec();
+  results[20] = test_varint();
+  results[21] = test_data_bases();
+  results[22] = test_itoa_len();
+  results[23] = test_median_histogram();
+  results[24] = test_compute_statistics();
+  results[25] = test_stats_simd();
+  results[26] = test_find_kth();
+  results[27] = test_stats_accumulator();
+  results[28] = test_stats_window();
+  results[29] = test_mem_small();
 
   for ( i = 0; i < TESTCOUNT; i++) 
   {
@@ -346,4 +1864,8 @@ void course1(void)
   PRINTF("  PASSED: %d / %d\n", (TESTCOUNT - failed), TESTCOUNT);
   PRINTF("  FAILED: %d / %d\n", failed, TESTCOUNT);
   PRINTF("--------------------------------\n");
+
+#if defined (DEFERRED_LOG)
+  dlog_flush(NULL);
+#endif
 }
@@ -24,70 +24,1931 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "data.h"
+#include "memory.h"
+#include "platform.h"
 
-uint8_t my_itoa(int32_t data, uint8_t * ptr, uint32_t base) {
+#if defined (HOST) && defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined (HOST) && defined (__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+/* Kernels that must be inlined so a constant base folds into them */
+#define DATA_BASE_INLINE static inline __attribute__((always_inline))
+
+#if defined (MSP432)
+#define DATA_CLZ(x) __CLZ(x)
+#define DATA_CTZ(x) __CLZ(__RBIT(x))
+#else
+#define DATA_CLZ(x) __builtin_clz(x)
+#define DATA_CTZ(x) __builtin_ctz(x)
+#endif
+
+/* Digit symbols for every supported base, up to base 32 */
+static const uint8_t digit_chars[32] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D',
+    'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R',
+    'S', 'T', 'U', 'V'
+};
+
+/* ceil(bits / shift) as (bits + shift - 1) * recip >> 8, exact for bits <= 32 */
+static const uint16_t shift_reciprocal[6] = { 0, 256, 128, 86, 64, 52 };
+
+/* Native register width used by the SWAR text kernels */
+#if defined (MSP432)
+typedef uint32_t swar_t;
+#define SWAR_ONES ((swar_t) 0x01010101u)
+#define SWAR_DECIMAL_SCALE (10000u)       /* 10^4: one word of digits */
+#else
+typedef uint64_t swar_t;
+#define SWAR_ONES ((swar_t) 0x0101010101010101ull)
+#define SWAR_DECIMAL_SCALE (100000000u)   /* 10^8: one word of digits */
+#endif
+#define SWAR_CHARS (sizeof(swar_t))
+
+/* swar_t that may live at any byte address */
+#if defined (MSP432)
+typedef unaligned_word_t unaligned_swar_t;
+#else
+typedef struct __attribute__((packed)) {
+    swar_t word;
+} unaligned_swar_t;
+#endif
+
+/*
+ * Sets the top bit of every byte lane holding a value strictly between
+ * `lo` and `hi`. Exact as long as every lane is below 0x80.
+ */
+#define SWAR_BETWEEN(x, lo, hi) \
+    (((SWAR_ONES * (127 + (hi)) - ((x) & SWAR_ONES * 127)) & ~(x) & \
+      (((x) & SWAR_ONES * 127) + SWAR_ONES * (127 - (lo)))) & SWAR_ONES * 128)
+
+#define IS_POWER_OF_2_BASE(base) \
+    ((base) >= 2 && (base) <= 32 && ((base) & ((base) - 1)) == 0)
+
+/* "00" to "99": two decimal digits per lookup */
+static const uint8_t digit_pairs[200] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint32_t powers_of_10[10] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u,
+    100000000u, 1000000000u
+};
+
+/* value / 100 for any 32-bit value, as a multiply by 2^37 / 100 */
+#define DIV100(value) ((uint32_t)(((uint64_t)(value) * 0x51EB851Fu) >> 37))
+
+/*
+ * Number of decimal digits in `value` (1 for 0). The bit length from CLZ
+ * times log10(2) (~1233 / 4096) gives the count to within one, and a
+ * single table comparison fixes it up.
+ */
+static inline uint8_t decimal_digits(uint32_t value) {
+    uint32_t x = value | 1;
+    uint32_t t = ((32 - DATA_CLZ(x)) * 1233) >> 12;
+    return (uint8_t)(t + 1 - (x < *(powers_of_10 + t)));
+}
+
+/*
+ * Writes the decimal digits of `value` so that the last one ends
+ * just before `end`, two digits per step and without a reverse pass.
+ */
+static inline void write_decimal(uint32_t value, uint8_t * end) {
+    while (value >= 100) {
+        uint32_t q = DIV100(value);
+        const uint8_t * pair = digit_pairs + 2 * (value - q * 100);
+        end -= 2;
+        *end = *pair;
+        *(end + 1) = *(pair + 1);
+        value = q;
+    }
+    if (value >= 10) {
+        end -= 2;
+        *end = *(digit_pairs + 2 * value);
+        *(end + 1) = *(digit_pairs + 2 * value + 1);
+    } else {
+        *--end = (uint8_t)('0' + value);
+    }
+}
+
+/*
+ * Writes `value` in base 16 as exactly 8 digits, zero padded, at `out`.
+ * Every nibble is spread into its own byte lane and all eight are turned
+ * into ASCII at once.
+ */
+static inline void write_hex8(uint32_t value, uint8_t * out) {
+#if defined (HOST) && defined (__SSSE3__)
+    const __m128i hex = _mm_loadu_si128((__m128i *) digit_chars);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i v = _mm_cvtsi32_si128((int) __builtin_bswap32(value));
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+    __m128i lo = _mm_and_si128(v, nibble);
+    _mm_storel_epi64((__m128i *) out,
+                     _mm_shuffle_epi8(hex, _mm_unpacklo_epi8(hi, lo)));
+#elif defined (HOST)
+    uint64_t x = value;
+    x = ((x & 0xFFFF0000ull) << 16) | (x & 0x0000FFFFull);
+    x = ((x & 0x0000FF000000FF00ull) << 8) | (x & 0x000000FF000000FFull);
+    x = ((x & 0x00F000F000F000F0ull) << 4) | (x & 0x000F000F000F000Full);
+    x = __builtin_bswap64(x);  // most significant digit first in memory
+    /* Lanes above 9 get the extra 7 that skips from '9' to 'A' */
+    x += 0x3030303030303030ull +
+         (((x + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull) * 7;
+    for (int i = 0; i < 8; i++) {
+        *(out + i) = (uint8_t)(x >> (8 * i));
+    }
+#else
+    for (int i = 7; i >= 0; i--) {
+        *(out + i) = *(digit_chars + (value & 0xF));
+        value >>= 4;
+    }
+#endif
+}
+
+/*
+ * Writes `value` in a power-of-two base using shifts and masks only. The
+ * digit count comes from the bit length, so no reverse pass is needed.
+ * Returns the number of digits written.
+ */
+static inline uint8_t write_power_of_2(uint32_t value, uint8_t * out,
+                                       uint32_t base) {
+    uint32_t shift = DATA_CTZ(base);
+    uint32_t mask = base - 1;
+    uint32_t bits = 32 - DATA_CLZ(value | 1);
+    uint8_t count = (uint8_t)(((bits + shift - 1) *
+                               *(shift_reciprocal + shift)) >> 8);
+    uint8_t * end = out + count;
+
+    if (shift == 4) {
+        uint8_t temp[8];
+        write_hex8(value, temp);
+        for (uint8_t i = 0; i < count; i++) {
+            *(out + i) = *(temp + 8 - count + i);
+        }
+        return count;
+    }
+
+    do {
+        *--end = *(digit_chars + (value & mask));
+        value >>= shift;
+    } while (end > out);
+    return count;
+}
+
+/*
+ * Writes the unsigned `value` in `base` at `ptr` without a null terminator
+ * and returns the number of characters written.
+ */
+DATA_BASE_INLINE uint8_t write_magnitude(uint32_t value, uint8_t * ptr,
+                                         uint32_t base) {
     uint8_t * start = ptr;
-    uint8_t temp[33];
+    uint8_t temp[32];
     int i = 0;
+
+    if (base == 10) {
+        ptr += decimal_digits(value);
+        write_decimal(value, ptr);
+        return (uint8_t)(ptr - start);
+    }
+
+    if (IS_POWER_OF_2_BASE(base)) {
+        return write_power_of_2(value, ptr, base);
+    }
+
+    do {
+        uint32_t rem = value % base;
+        *(temp + i++) = (rem > 9) ? (rem - 10 + 'A') : (rem + '0');
+        value /= base;
+    } while (value != 0);
+
+    // Reverse the digits
+    for (int j = i - 1; j >= 0; j--) {
+        *ptr++ = *(temp + j);
+    }
+
+    return (uint8_t)(ptr - start);
+}
+
+/*
+ * Writes `data` in `base` at `ptr` without a null terminator and returns
+ * the number of characters written. Shared by my_itoa() and the batch
+ * formatters.
+ */
+DATA_BASE_INLINE uint8_t write_integer(int32_t data, uint8_t * ptr,
+                                       uint32_t base) {
+    /* Magnitude as unsigned so INT32_MIN does not overflow */
+    if (data < 0) {
+        *ptr = '-';
+        return 1 + write_magnitude(0u - (uint32_t) data, ptr + 1, base);
+    }
+    return write_magnitude((uint32_t) data, ptr, base);
+}
+
+/*
+ * Number of characters write_integer() produces for `data` in `base`:
+ * CLZ and the powers-of-10 table for base 10, the bit length for powers
+ * of two, and a divide loop only for the remaining bases.
+ */
+static uint8_t integer_length(int32_t data, uint32_t base) {
+    uint8_t count = (data < 0);
+    uint32_t value = (data < 0) ? 0u - (uint32_t) data : (uint32_t) data;
+
+    if (base == 10) {
+        return count + decimal_digits(value);
+    }
+    if (IS_POWER_OF_2_BASE(base)) {
+        uint32_t shift = DATA_CTZ(base);
+        uint32_t bits = 32 - DATA_CLZ(value | 1);
+        return count + (uint8_t)(((bits + shift - 1) *
+                                  *(shift_reciprocal + shift)) >> 8);
+    }
+    do {
+        count++;
+        value /= base;
+    } while (value != 0);
+    return count;
+}
+
+uint8_t my_itoa_len(int32_t value, uint32_t base) {
+    return integer_length(value, base);
+}
+
+#if defined (HOST) && defined (__SSE2__)
+/* Vectors summed in 32-bit lanes before they are folded into the total */
+#define ITOA_LEN_FOLD (1u << 24)
+
+/*
+ * Total decimal length of `n` values, four per step: the magnitude is
+ * compared against 10^1 .. 10^9 (unsigned, by flipping the sign bits)
+ * and every true compare adds a digit; negative values add the '-'.
+ */
+static size_t sse_decimal_array_length(int32_t * values, size_t n) {
+    const __m128i flip = _mm_set1_epi32((int32_t) 0x80000000u);
+    __m128i powers[9];
+    size_t total = 0;
+    size_t i = 0;
+
+    for (int k = 0; k < 9; k++) {
+        *(powers + k) = _mm_set1_epi32(
+            (int32_t)(*(powers_of_10 + k + 1) ^ 0x80000000u));
+    }
+    while (n - i >= 4) {
+        __m128i sum = _mm_setzero_si128();
+        size_t stop = i + 4 * (size_t) ITOA_LEN_FOLD;
+        int32_t lanes[4];
+
+        if (stop > n - n % 4) {
+            stop = n - n % 4;
+        }
+        for (; i < stop; i += 4) {
+            __m128i x = _mm_loadu_si128((__m128i *)(values + i));
+            __m128i sign = _mm_srai_epi32(x, 31);
+            __m128i biased = _mm_xor_si128(
+                _mm_sub_epi32(_mm_xor_si128(x, sign), sign), flip);
+            /* Each compare is -1 for biased < 10^k: count those instead */
+            sum = _mm_sub_epi32(sum, sign);
+            for (int k = 0; k < 9; k++) {
+                sum = _mm_add_epi32(sum, _mm_cmpgt_epi32(*(powers + k),
+                                                         biased));
+            }
+        }
+        _mm_storeu_si128((__m128i *) lanes, sum);
+        /* Lanes are negative: modular size_t sums still come out right */
+        total += (size_t) *lanes + (size_t) *(lanes + 1) +
+                 (size_t) *(lanes + 2) + (size_t) *(lanes + 3);
+    }
+    /* 10 digits per value, less one per power it is below */
+    total += 10 * i;
+    for (; i < n; i++) {
+        total += integer_length(*(values + i), 10);
+    }
+    return total;
+}
+#endif
+
+size_t my_itoa_array_len(int32_t * values, size_t n, uint32_t base,
+                         uint8_t sep) {
+    size_t total = (n > 0 && sep != '\0') ? n - 1 : 0;
+
+#if defined (HOST) && defined (__SSE2__)
+    if (base == 10) {
+        return total + sse_decimal_array_length(values, n);
+    }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        total += integer_length(*(values + i), base);
+    }
+    return total;
+}
+
+DATA_BASE_INLINE uint8_t itoa_kernel(int32_t data, uint8_t * ptr,
+                                     uint32_t base) {
+    uint8_t count = write_integer(data, ptr, base);
+    *(ptr + count) = '\0';
+    return count + 1; // including null terminator
+}
+
+/* Parenthesized: my_itoa() is also a dispatch macro in data.h */
+uint8_t (my_itoa)(int32_t data, uint8_t * ptr, uint32_t base) {
+    return itoa_kernel(data, ptr, base);
+}
+
+size_t my_itoa_array(int32_t * values, size_t n, uint32_t base, uint8_t sep,
+                     uint8_t * out, size_t out_cap) {
+    size_t written = 0;   // Length of the complete output in `out`
+
+    for (size_t i = 0; i < n; i++) {
+        int32_t data = *(values + i);
+        size_t sep_length = (i > 0 && sep != '\0');
+
+        /* With room for the longest value there is no need to measure */
+        if (out_cap - written < sep_length + ITOA_MAX_CHARS &&
+            out_cap - written < sep_length + integer_length(data, base)) {
+            /* Full: measure the rest in one pass */
+            return written + sep_length +
+                   my_itoa_array_len(values + i, n - i, base, sep);
+        }
+        if (sep_length) {
+            *(out + written++) = sep;
+        }
+        written += write_integer(data, out + written, base);
+    }
+    return written;
+}
+/*
+ * Divides `*value` by `divisor` (below 2^16) using only 32-bit divides, one
+ * 16-bit limb at a time, so the Cortex-M4 never needs a 64-bit division
+ * helper. Returns the remainder.
+ */
+static uint32_t div64_by_small(uint64_t * value, uint32_t divisor) {
+    uint32_t hi = (uint32_t)(*value >> 32);
+    uint32_t lo = (uint32_t) *value;
+    uint32_t q3 = (hi >> 16) / divisor;
+    uint32_t rem = (hi >> 16) - q3 * divisor;
+    uint32_t cur = (rem << 16) | (hi & 0xFFFFu);
+    uint32_t q2 = cur / divisor;
+    uint32_t q1;
+    uint32_t q0;
+
+    rem = cur - q2 * divisor;
+    cur = (rem << 16) | (lo >> 16);
+    q1 = cur / divisor;
+    rem = cur - q1 * divisor;
+    cur = (rem << 16) | (lo & 0xFFFFu);
+    q0 = cur / divisor;
+    rem = cur - q0 * divisor;
+
+    *value = ((uint64_t)((q3 << 16) | q2) << 32) | ((q1 << 16) | q0);
+    return rem;
+}
+
+uint8_t my_itoa64(int64_t data, uint8_t * ptr, uint32_t base) {
+    uint8_t * start = ptr;
+    uint8_t temp[64];
+    uint8_t * chunks = temp + sizeof(temp);
+    uint64_t value = (data < 0) ? 0u - (uint64_t) data : (uint64_t) data;
+
+    if (data < 0) {
+        *ptr++ = '-';
+    }
+
+    if (IS_POWER_OF_2_BASE(base)) {
+        /* Shifts and masks only: the halves never need dividing */
+        uint32_t shift = DATA_CTZ(base);
+        do {
+            *--chunks = *(digit_chars + ((uint32_t) value & (base - 1)));
+            value >>= shift;
+        } while (value >> 32);
+    } else {
+        /*
+         * Peel off chunks of k digits, where base^k is the largest power
+         * below 2^16, until the rest fits the 32-bit kernels. A 64-bit
+         * value needs at most three rounds in base 10.
+         */
+        uint32_t divisor = base;
+        uint32_t k = 1;
+        while (divisor * base <= 0xFFFFu) {
+            divisor *= base;
+            k++;
+        }
+        while (value >> 32) {
+            uint32_t rem = div64_by_small(&value, divisor);
+            if (base == 10) {
+                uint32_t q = DIV100(rem);
+                chunks -= 4;
+                *chunks = *(digit_pairs + 2 * q);
+                *(chunks + 1) = *(digit_pairs + 2 * q + 1);
+                *(chunks + 2) = *(digit_pairs + 2 * (rem - q * 100));
+                *(chunks + 3) = *(digit_pairs + 2 * (rem - q * 100) + 1);
+            } else {
+                for (uint32_t i = 0; i < k; i++) {
+                    *--chunks = *(digit_chars + rem % base);
+                    rem /= base;
+                }
+            }
+        }
+    }
+
+    /* The high part has no leading zeros; the chunks are zero padded */
+    if ((uint32_t) value != 0 || chunks == temp + sizeof(temp)) {
+        ptr += write_magnitude((uint32_t) value, ptr, base);
+    } else {
+        while (chunks < temp + sizeof(temp) - 1 && *chunks == '0') {
+            chunks++;
+        }
+    }
+    while (chunks < temp + sizeof(temp)) {
+        *ptr++ = *chunks++;
+    }
+    *ptr = '\0';
+    return (uint8_t)((ptr - start) + 1); // including null terminator
+}
+
+/* True if every byte of `x` is an ASCII decimal digit */
+static inline int swar_all_decimal(swar_t x) {
+    return ((x & (SWAR_ONES * 0xF0)) |
+            (((x + SWAR_ONES * 0x06) & (SWAR_ONES * 0xF0)) >> 4))
+           == SWAR_ONES * 0x33;
+}
+
+/* True if every byte of `x` is an ASCII hexadecimal digit */
+static inline int swar_all_hex(swar_t x) {
+    swar_t in_range = SWAR_BETWEEN(x, '0' - 1, '9' + 1) |
+                      SWAR_BETWEEN(x, 'A' - 1, 'F' + 1) |
+                      SWAR_BETWEEN(x, 'a' - 1, 'f' + 1);
+    return (x & SWAR_ONES * 0x80) == 0 && in_range == SWAR_ONES * 0x80;
+}
+
+/*
+ * Appends the decimal digits held in `x` (first character in the lowest
+ * byte) to `result`. Adjacent digits are first merged into two-digit lane
+ * values, then the lanes are folded with multiply-adds.
+ */
+static inline uint32_t swar_decimal_accumulate(uint32_t result, swar_t x) {
+    x -= SWAR_ONES * '0';
+    x = x * 10 + (x >> 8);
+#if defined (MSP432)
+    /* result * 10^4 + hi_pair * 100 + lo_pair in a single SMLAD */
+    return __SMLAD((uint32_t)(x & 0x00FF00FFu), 0x00010064u,
+                   result * SWAR_DECIMAL_SCALE);
+#else
+    x = (((x & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+         (((x >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+    return result * SWAR_DECIMAL_SCALE + (uint32_t) x;
+#endif
+}
+
+/*
+ * Converts the hex digits held in `x` (first character in the lowest
+ * byte) to SWAR_CHARS / 2 bytes, the first of them in the lowest byte.
+ */
+static inline uint32_t swar_hex_bytes(swar_t x) {
+    /* '0'-'9' keep their low nibble, letters (bit 6 set) gain 9 */
+    x = (x & SWAR_ONES * 0x0F) + ((x >> 6) & SWAR_ONES) * 9;
+    /* Merge digit pairs into bytes at the bottom of each 16-bit lane */
+    x = ((x << 4) | (x >> 8)) & (SWAR_ONES / 0x0101 * 0x00FF);
+#if defined (MSP432)
+    return (uint32_t)(x | (x >> 8)) & 0xFFFFu;
+#else
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+    return (uint32_t)(x | (x >> 16));
+#endif
+}
+
+/*
+ * Appends the hexadecimal digits held in `x` (first character in the
+ * lowest byte) to `result`.
+ */
+static inline uint32_t swar_hex_accumulate(uint32_t result, swar_t x) {
+    uint32_t bytes = swar_hex_bytes(x);
+#if defined (MSP432)
+    return (result << 16) | ((bytes & 0xFFu) << 8) | (bytes >> 8);
+#else
+    (void) result;  // eight hex digits replace all 32 bits
+    return __builtin_bswap32(bytes);
+#endif
+}
+
+#if defined (HOST) && defined (__SSSE3__)
+/*
+ * Parses 16 decimal digits at `ptr`, or returns 0 through `ok` if any of
+ * them is not a digit. Digit pairs, quads and octets are combined with
+ * PMADDUBSW/PMADDWD multiply-add reductions.
+ */
+static inline uint64_t sse_decimal16(uint8_t * ptr, int * ok) {
+    __m128i v = _mm_loadu_si128((__m128i *) ptr);
+    __m128i bad = _mm_or_si128(_mm_cmplt_epi8(v, _mm_set1_epi8('0')),
+                               _mm_cmpgt_epi8(v, _mm_set1_epi8('9')));
+    __m128i t;
+
+    *ok = (_mm_movemask_epi8(bad) == 0);
+    if (!*ok) return 0;
+
+    t = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    t = _mm_maddubs_epi16(t, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1,
+                                            10, 1, 10, 1, 10, 1, 10, 1));
+    t = _mm_madd_epi16(t, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    t = _mm_packs_epi32(t, t);
+    t = _mm_madd_epi16(t, _mm_setr_epi16(10000, 1, 10000, 1,
+                                         10000, 1, 10000, 1));
+    return (uint64_t)(uint32_t) _mm_cvtsi128_si32(t) * 100000000u +
+           (uint32_t) _mm_cvtsi128_si32(_mm_srli_si128(t, 4));
+}
+#endif
+
+/* Value of the digit character `c`, or 0xFF if it is not a digit */
+static inline uint8_t digit_value(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c |= 0x20;  // fold to lower case
+    if (c >= 'a' && c <= 'v') return c - 'a' + 10;
+    return 0xFF;
+}
+
+DATA_BASE_INLINE int32_t atoi_kernel(uint8_t * ptr, uint8_t digits,
+                                     uint32_t base) {
+    uint32_t result = 0;
     int is_negative = 0;
 
-    if (data == 0) {
+    if (*ptr == '-') {
+        is_negative = 1;
+        ptr++;
+        digits--;
+    }
+
+    /*
+     * Decimal and hex strings are consumed a whole word of characters at
+     * a time while the word holds only digits; the per-character loops
+     * below finish the remainder.
+     */
+    if (base == 10) {
+#if defined (HOST) && defined (__SSSE3__)
+        int ok = 1;
+        while (digits >= 16) {
+            uint64_t chunk = sse_decimal16(ptr, &ok);
+            if (!ok) break;
+            result = result * (uint32_t) 10000000000000000ull + (uint32_t) chunk;
+            ptr += 16;
+            digits -= 16;
+        }
+#endif
+        while (digits >= SWAR_CHARS) {
+            swar_t x = ((unaligned_swar_t *) ptr)->word;
+            if (!swar_all_decimal(x)) break;
+            result = swar_decimal_accumulate(result, x);
+            ptr += SWAR_CHARS;
+            digits -= SWAR_CHARS;
+        }
+    } else if (base == 16) {
+        while (digits >= SWAR_CHARS) {
+            swar_t x = ((unaligned_swar_t *) ptr)->word;
+            if (!swar_all_hex(x)) break;
+            result = swar_hex_accumulate(result, x);
+            ptr += SWAR_CHARS;
+            digits -= SWAR_CHARS;
+        }
+    }
+
+    if (IS_POWER_OF_2_BASE(base)) {
+        uint32_t shift = DATA_CTZ(base);
+        while (digits-- && *ptr != '\0') {
+            uint8_t value = digit_value(*ptr++);
+            if (value >= base) {
+                return 0; // Invalid character
+            }
+            result = (result << shift) | value;
+        }
+    } else {
+        while (digits-- && *ptr != '\0') {
+            uint8_t value = digit_value(*ptr++);
+            if (value >= base) {
+                return 0; // Invalid character
+            }
+            result = result * base + value;
+        }
+    }
+
+    return (int32_t)(is_negative ? 0u - result : result);
+}
+
+int32_t (my_atoi)(uint8_t * ptr, uint8_t digits, uint32_t base) {
+    return atoi_kernel(ptr, digits, base);
+}
+
+/*
+ * Per-base entry points. The base is a literal here, so once the kernels
+ * are inlined every base test folds away and the divides, multiplies and
+ * shifts by the base use constants.
+ */
+#define DATA_DEFINE_BASE(base) \
+    uint8_t my_itoa_base##base(int32_t data, uint8_t * ptr) { \
+        return itoa_kernel(data, ptr, base); \
+    } \
+    int32_t my_atoi_base##base(uint8_t * ptr, uint8_t digits) { \
+        return atoi_kernel(ptr, digits, base); \
+    }
+
+DATA_DEFINE_BASE(2)
+DATA_DEFINE_BASE(8)
+DATA_DEFINE_BASE(10)
+DATA_DEFINE_BASE(16)
+
+/*
+ * Normalized 64-bit significands and binary exponents of the cached powers
+ * 10^-36, 10^-28, ..., 10^52, which cover every float. Entry i is step
+ * GRISU_FIRST_STEP + i of the series 10^(-348 + 8 * step) used by Grisu.
+ */
+static const uint64_t grisu_power_f[12] = {
+    0xAA242499697392D3ull, 0xFD87B5F28300CA0Eull, 0xBCE5086492111AEBull,
+    0x8CBCCC096F5088CCull, 0xD1B71758E219652Cull, 0x9C40000000000000ull,
+    0xE8D4A51000000000ull, 0xAD78EBC5AC620000ull, 0x813F3978F8940984ull,
+    0xC097CE7BC90715B3ull, 0x8F7E32CE7BEA5C70ull, 0xD5D238A4ABE98068ull
+};
+static const int16_t grisu_power_e[12] = {
+    -183, -157, -130, -103, -77, -50, -24, 3, 30, 56, 83, 109
+};
+#define GRISU_FIRST_STEP (39)
+
+#define FLOAT_HIDDEN_BIT (0x00800000u)
+
+/* Floating-point value f * 2^e with a 64-bit significand */
+typedef struct {
+    uint64_t f;
+    int32_t e;
+} diy_fp_t;
+
+static inline uint32_t clz64(uint64_t x) {
+    uint32_t hi = (uint32_t)(x >> 32);
+    return hi ? DATA_CLZ(hi) : 32 + DATA_CLZ((uint32_t) x);
+}
+
+static inline diy_fp_t diy_fp_normalize(diy_fp_t x) {
+    uint32_t shift = clz64(x.f);
+    x.f <<= shift;
+    x.e -= (int32_t) shift;
+    return x;
+}
+
+/* Rounded high half of the 128-bit product, from 32x32-bit multiplies */
+static diy_fp_t diy_fp_multiply(diy_fp_t x, diy_fp_t y) {
+    uint64_t a = x.f >> 32;
+    uint64_t b = x.f & 0xFFFFFFFFu;
+    uint64_t c = y.f >> 32;
+    uint64_t d = y.f & 0xFFFFFFFFu;
+    uint64_t ac = a * c;
+    uint64_t bc = b * c;
+    uint64_t ad = a * d;
+    uint64_t bd = b * d;
+    uint64_t mid = (bd >> 32) + (ad & 0xFFFFFFFFu) + (bc & 0xFFFFFFFFu) +
+                   (1u << 31);
+    diy_fp_t r;
+
+    r.f = ac + (ad >> 32) + (bc >> 32) + (mid >> 32);
+    r.e = x.e + y.e + 64;
+    return r;
+}
+
+/* Moves the last digit down while that brings it closer to the value */
+static void grisu_round(uint8_t * buffer, int length, uint64_t delta,
+                        uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w ||
+            wp_w - rest > rest + ten_kappa - wp_w)) {
+        (*(buffer + length - 1))--;
+        rest += ten_kappa;
+    }
+}
+
+/*
+ * Generates the shortest digits of w that stay inside (m-, m+), where
+ * `mp` is m+ and `delta` is m+ - m-. Returns the digit count and adds the
+ * decimal exponent of the last digit to `*k`. `*near` is set when the
+ * position above the last digit missed only by up to `slack`, so a
+ * shorter result may fit an interval that much wider.
+ */
+static int grisu_digit_gen(diy_fp_t w, diy_fp_t mp, uint64_t delta,
+                           uint64_t slack, uint8_t * buffer, int * k,
+                           int * near) {
+    uint32_t shift = (uint32_t)(-mp.e);
+    uint64_t one = 1ull << shift;
+    uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> shift);
+    uint64_t p2 = mp.f & (one - 1);
+    int kappa = decimal_digits(p1);
+    int length = 0;
+
+    /* Above the first digit only rounding up to 10^kappa can come close */
+    *near = kappa < 10 && *(powers_of_10 + kappa) - p1 == 1 &&
+            one - p2 <= slack;
+
+    while (kappa > 0) {
+        uint32_t d = p1 / *(powers_of_10 + kappa - 1);
+        uint64_t rest;
+        uint64_t ten_kappa;
+        p1 -= d * *(powers_of_10 + kappa - 1);
+        if (d || length) {
+            *(buffer + length++) = (uint8_t)('0' + d);
+        }
+        kappa--;
+        rest = ((uint64_t) p1 << shift) + p2;
+        ten_kappa = (uint64_t) *(powers_of_10 + kappa) << shift;
+        if (rest <= delta) {
+            *k += kappa;
+            grisu_round(buffer, length, delta, rest, ten_kappa, wp_w);
+            return length;
+        }
+        *near = rest - delta <= slack || ten_kappa - rest <= slack;
+    }
+
+    for (;;) {
+        uint32_t d;
+        p2 *= 10;
+        delta *= 10;
+        wp_w *= 10;
+        slack *= 10;
+        d = (uint32_t)(p2 >> shift);
+        if (d || length) {
+            *(buffer + length++) = (uint8_t)('0' + d);
+        }
+        p2 &= one - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            grisu_round(buffer, length, delta, p2, one, wp_w);
+            return length;
+        }
+        *near = p2 - delta <= slack || one - p2 <= slack;
+    }
+}
+
+/*
+ * Exact unsigned integer, lowest limb first. The largest products compared
+ * below, a 31-bit digit string times 2^151 or a 27-bit bound times 10^46,
+ * stay under 183 bits.
+ */
+#define BIG_LIMBS (6)
+typedef struct {
+    uint32_t limb[BIG_LIMBS];
+} big_t;
+
+static void big_set(big_t * x, uint64_t value) {
+    *(x->limb) = (uint32_t) value;
+    *(x->limb + 1) = (uint32_t)(value >> 32);
+    for (int i = 2; i < BIG_LIMBS; i++) *(x->limb + i) = 0;
+}
+
+static void big_mul_pow10(big_t * x, uint32_t n) {
+    while (n) {
+        uint32_t step = n > 9 ? 9 : n;
+        uint64_t carry = 0;
+        for (int i = 0; i < BIG_LIMBS; i++) {
+            carry += (uint64_t) *(x->limb + i) * *(powers_of_10 + step);
+            *(x->limb + i) = (uint32_t) carry;
+            carry >>= 32;
+        }
+        n -= step;
+    }
+}
+
+static void big_shift_left(big_t * x, uint32_t bits) {
+    uint32_t words = bits / 32;
+    uint32_t shift = bits % 32;
+
+    for (int i = BIG_LIMBS - 1; i >= 0; i--) {
+        uint32_t hi = i >= (int) words ? *(x->limb + i - words) : 0;
+        uint32_t lo = i > (int) words ? *(x->limb + i - words - 1) : 0;
+        *(x->limb + i) = shift ? (hi << shift) | (lo >> (32 - shift)) : hi;
+    }
+}
+
+/* Sign of d * 10^p - y * 2^q, computed exactly */
+static int big_compare(uint64_t d, int p, uint64_t y, int32_t q) {
+    big_t a;
+    big_t b;
+
+    big_set(&a, d);
+    big_set(&b, y);
+    if (p >= 0) big_mul_pow10(&a, (uint32_t) p);
+    else big_mul_pow10(&b, (uint32_t) -p);
+    if (q >= 0) big_shift_left(&b, (uint32_t) q);
+    else big_shift_left(&a, (uint32_t) -q);
+
+    for (int i = BIG_LIMBS - 1; i >= 0; i--) {
+        if (*(a.limb + i) != *(b.limb + i)) {
+            return *(a.limb + i) < *(b.limb + i) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Whether d * 10^p reads back as f * 2^e. The bounds are the midpoints to
+ * the neighbouring floats, in units of 2^(e - 2); a parser rounding half
+ * to even accepts them when f is even.
+ */
+static int ftoa_reads_back(uint64_t d, int p, uint32_t f, int32_t e) {
+    uint64_t lower = (f == FLOAT_HIDDEN_BIT && e > -149) ? 4ull * f - 1 : 4ull * f - 2;
+    uint64_t upper = 4ull * f + 2;
+    int strict = (int)(f & 1);
+
+    return big_compare(d, p, lower, e - 2) >= strict &&
+           big_compare(d, p, upper, e - 2) <= -strict;
+}
+
+/*
+ * Moves the digits of f * 2^e up to coarser positions while a neighbour
+ * at the next position still reads back; the closer neighbour wins.
+ * Returns the new digit count.
+ */
+static int ftoa_shorten(uint32_t f, int32_t e, uint8_t * buffer, int length,
+                        int * k) {
+    uint32_t digits = 0;
+
+    for (int i = 0; i < length; i++) {
+        digits = digits * 10 + (uint32_t)(*(buffer + i) - '0');
+    }
+    for (;;) {
+        uint32_t down = digits / 10;
+        int up_fits = ftoa_reads_back(down + 1ull, *k + 1, f, e);
+        int down_fits = down && ftoa_reads_back(down, *k + 1, f, e);
+
+        if (up_fits && down_fits) {
+            /* Midpoint of the two below the value: rounding up is closer */
+            up_fits = big_compare(2ull * down + 1, *k + 1, 8ull * f, e - 2) < 0;
+        } else if (!up_fits && !down_fits) {
+            break;
+        }
+        digits = up_fits ? down + 1 : down;
+        (*k)++;
+    }
+    length = write_magnitude(digits, buffer, 10);
+    while (length > 1 && *(buffer + length - 1) == '0') {
+        length--;
+        (*k)++;
+    }
+    return length;
+}
+
+/*
+ * Grisu2 for single precision: writes the shortest digits of f * 2^e to
+ * `buffer` and returns their count; the value is digits * 10^k.
+ */
+static int grisu2(uint32_t f, int32_t e, uint8_t * buffer, int * k) {
+    diy_fp_t v = { f, e };
+    diy_fp_t plus = { ((uint64_t) f << 1) + 1, e - 1 };
+    diy_fp_t minus;
+    diy_fp_t c;
+    diy_fp_t w;
+    int32_t x;
+    int32_t step;
+    int length;
+    int near;
+
+    plus = diy_fp_normalize(plus);
+    if (f == FLOAT_HIDDEN_BIT) {
+        minus.f = ((uint64_t) f << 2) - 1;
+        minus.e = e - 2;
+    } else {
+        minus.f = ((uint64_t) f << 1) - 1;
+        minus.e = e - 1;
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    /*
+     * Pick the cached power that brings the product's exponent into
+     * [-60, -32]: step = ceil((-61 - e) * log10(2)) + 347, divided by 8,
+     * with log10(2) approximated as 78913 / 2^18.
+     */
+    x = -61 - plus.e;
+    step = (347 + ((x * 78913 + (1 << 18) - 1) >> 18)) / 8 + 1;
+    c.f = *(grisu_power_f + step - GRISU_FIRST_STEP);
+    c.e = *(grisu_power_e + step - GRISU_FIRST_STEP);
+    *k = 348 - step * 8;
+
+    w = diy_fp_multiply(diy_fp_normalize(v), c);
+    plus = diy_fp_multiply(plus, c);
+    minus = diy_fp_multiply(minus, c);
+
+    /*
+     * The products are off by less than one unit, so digits chosen inside
+     * the interval narrowed by a unit always read back. A shorter result
+     * within two units of the narrowed bounds, such as one on a bound that
+     * an even f accepts, is settled exactly instead.
+     */
+    minus.f++;
+    plus.f--;
+    length = grisu_digit_gen(w, plus, plus.f - minus.f, 2, buffer, k, &near);
+    if (near) {
+        length = ftoa_shorten(f, e, buffer, length, k);
+    }
+    return length;
+}
+
+uint8_t my_ftoa(float data, uint8_t * ptr) {
+    uint8_t * start = ptr;
+    uint8_t digits[FTOA_MAX_CHARS];
+    union {
+        float f;
+        uint32_t u;
+    } bits;
+    uint32_t exponent;
+    uint32_t fraction;
+    int length;
+    int k;
+    int point;
+
+    bits.f = data;
+    exponent = (bits.u >> 23) & 0xFFu;
+    fraction = bits.u & (FLOAT_HIDDEN_BIT - 1);
+
+    if (exponent == 0xFFu) {
+        const char * text = fraction ? "nan" : ((bits.u >> 31) ? "-inf" : "inf");
+        while (*text) {
+            *ptr++ = (uint8_t) *text++;
+        }
+        *ptr = '\0';
+        return (uint8_t)((ptr - start) + 1); // including null terminator
+    }
+
+    if (bits.u >> 31) {
+        *ptr++ = '-';
+    }
+    if (exponent == 0 && fraction == 0) {
         *ptr++ = '0';
         *ptr = '\0';
-        return 2; // '0' and null terminator
+        return (uint8_t)((ptr - start) + 1); // including null terminator
     }
 
-    if (data < 0 && base == 10) {
-        is_negative = 1;
-        data = -data;
+    if (exponent == 0) {
+        length = grisu2(fraction, -149, digits, &k);
+    } else {
+        length = grisu2(fraction | FLOAT_HIDDEN_BIT, (int32_t) exponent - 150,
+                        digits, &k);
     }
 
-    while (data != 0) {
-        int rem = data % base;
-        *(temp + i++) = (rem > 9) ? (rem - 10 + 'A') : (rem + '0');
-        data /= base;
+    /* Position of the decimal point relative to the first digit */
+    point = length + k;
+
+    if (k >= 0 && point <= FTOA_FIXED_DIGITS) {
+        /* 1234e2 -> 123400 */
+        for (int i = 0; i < length; i++) *ptr++ = *(digits + i);
+        for (int i = 0; i < k; i++) *ptr++ = '0';
+    } else if (point > 0 && point <= FTOA_FIXED_DIGITS) {
+        /* 1234e-2 -> 12.34 */
+        for (int i = 0; i < length; i++) {
+            if (i == point) *ptr++ = '.';
+            *ptr++ = *(digits + i);
+        }
+    } else if (point > -6 && point <= 0) {
+        /* 1234e-6 -> 0.001234 */
+        *ptr++ = '0';
+        *ptr++ = '.';
+        for (int i = point; i < 0; i++) *ptr++ = '0';
+        for (int i = 0; i < length; i++) *ptr++ = *(digits + i);
+    } else {
+        /* 1234e30 -> 1.234e33 */
+        *ptr++ = *digits;
+        if (length > 1) {
+            *ptr++ = '.';
+            for (int i = 1; i < length; i++) *ptr++ = *(digits + i);
+        }
+        *ptr++ = 'e';
+        if (point - 1 < 0) {
+            *ptr++ = '-';
+            ptr += write_magnitude((uint32_t)(1 - point), ptr, 10);
+        } else {
+            ptr += write_magnitude((uint32_t)(point - 1), ptr, 10);
+        }
     }
 
-    if (is_negative) {
-        *(temp + i++) = '-';
+    *ptr = '\0';
+    return (uint8_t)((ptr - start) + 1); // including null terminator
+}
+
+uint8_t my_qtoa(int32_t data, uint8_t frac_bits, uint8_t decimals,
+                uint8_t * ptr) {
+    uint8_t * start = ptr;
+    uint32_t magnitude = (data < 0) ? 0u - (uint32_t) data : (uint32_t) data;
+    uint32_t integer = (frac_bits < 32) ? magnitude >> frac_bits : 0;
+    uint32_t fraction = 0;
+
+    if (decimals > 9) {
+        decimals = 9;
     }
 
-    // Reverse the digits
-    for (int j = i - 1; j >= 0; j--) {
-        *ptr++ = *(temp + j);
+    if (frac_bits > 0 && decimals > 0) {
+        /* Fraction scaled to `decimals` digits, rounded half up */
+        uint64_t part = magnitude & (uint32_t)((1ull << frac_bits) - 1);
+        part = (part * *(powers_of_10 + decimals) +
+                (1ull << (frac_bits - 1))) >> frac_bits;
+        if (part == *(powers_of_10 + decimals)) {
+            integer++;
+            part = 0;
+        }
+        fraction = (uint32_t) part;
+    } else if (frac_bits > 0 &&
+               (magnitude >> (frac_bits - 1)) & 1u) {
+        integer++;  // no decimals: round the integer part
     }
 
-    *ptr = '\0';
+    if (data < 0 && (integer | fraction) != 0) {
+        *ptr++ = '-';
+    }
+    ptr += write_magnitude(integer, ptr, 10);
+    if (decimals > 0) {
+        *ptr++ = '.';
+        for (uint8_t i = 0; i < decimals; i++) {
+            *(ptr + i) = '0';
+        }
+        ptr += decimals;
+        write_decimal(fraction, ptr);
+    }
 
+    *ptr = '\0';
     return (uint8_t)((ptr - start) + 1); // including null terminator
 }
 
-int32_t my_atoi(uint8_t * ptr, uint8_t digits, uint32_t base) {
-    int32_t result = 0;
+/* Largest digit count whose every value fits 64 bits, per base */
+static const uint8_t digits_fitting_u64[33] = {
+    0, 0, 64, 40, 32, 27, 24, 22, 21, 20, 19, 18, 17, 17, 16, 16, 16,
+    15, 15, 15, 14, 14, 14, 14, 13, 13, 13, 13, 13, 13, 13, 12, 12
+};
+
+/* Largest digit count whose every value fits 32 bits, per base */
+static const uint8_t digits_fitting_u32[33] = {
+    0, 0, 31, 20, 15, 13, 12, 11, 10, 10, 9, 9, 8, 8, 8, 8, 7,
+    7, 7, 7, 7, 7, 7, 7, 6, 6, 6, 6, 6, 6, 6, 6, 6
+};
+
+int64_t my_atoi64(uint8_t * ptr, uint8_t digits, uint32_t base,
+                  uint8_t * overflow) {
+    uint64_t result = 0;
+    uint64_t limit = INT64_MAX;
+    uint8_t * end;
+    uint8_t * first;
     int is_negative = 0;
 
+    if (overflow) {
+        *overflow = 0;
+    }
+
     if (*ptr == '-') {
         is_negative = 1;
+        limit = (uint64_t) INT64_MAX + 1;
         ptr++;
         digits--;
     }
 
-    while (digits--) {
-        char c = *ptr++;
-        int value;
+    /* Validate and find the significant digits in one scan */
+    end = ptr;
+    while (digits-- && *end != '\0') {
+        if (digit_value(*end) >= base) {
+            return 0; // Invalid character
+        }
+        end++;
+    }
+    first = ptr;
+    while (first < end && *first == '0') {
+        first++;
+    }
+
+    /*
+     * Values with up to digits_fitting_u64 significant digits cannot wrap,
+     * and values with two or more digits beyond that always overflow. Only
+     * the single digit in between needs checking, so the accumulation loop
+     * itself has no overflow tests.
+     */
+    if (end - first > *(digits_fitting_u64 + base) + 1) {
+        result = limit;
+        if (overflow) *overflow = 1;
+    } else {
+        uint8_t * last = end;
+        int wraps = 0;
+
+        if (end - first > *(digits_fitting_u64 + base)) {
+            last--;
+        }
+        /* Accumulate 32-bit chunks, folding each into the 64-bit total */
+        while (first < last) {
+            uint32_t chunk = 0;
+            uint32_t scale = 1;
+            uint8_t count = *(digits_fitting_u32 + base);
+            while (count-- && first < last) {
+                chunk = chunk * base + digit_value(*first++);
+                scale *= base;
+            }
+            result = result * scale + chunk;
+        }
+        if (last < end) {
+            wraps = __builtin_mul_overflow(result, (uint64_t) base, &result) ||
+                    __builtin_add_overflow(result, (uint64_t) digit_value(*last),
+                                           &result);
+        }
+        if (wraps || result > limit) {
+            result = limit;
+            if (overflow) *overflow = 1;
+        }
+    }
+
+    return (int64_t)(is_negative ? 0u - result : result);
+}
+
+/* Bytes classified per step when scanning a stream for token boundaries */
+#if defined (HOST) && defined (__SSE2__)
+#define STREAM_USE_SSE2
+#define STREAM_BLOCK (16)
+#else
+#define STREAM_BLOCK (SWAR_CHARS)
+#endif
+
+/*
+ * Returns one bit per byte of the STREAM_BLOCK bytes at `ptr`, set where
+ * the byte is a digit in `base`, or a '-' if `sign` is set (bit 0 is the
+ * lowest address). Bases 10 and 16 are classified in parallel, other
+ * bases byte by byte.
+ */
+static inline uint32_t stream_digit_mask(uint8_t * ptr, uint32_t base,
+                                         int sign) {
+    uint32_t mask = 0;
+
+    if (base == 10 || base == 16) {
+#ifdef STREAM_USE_SSE2
+        __m128i v = _mm_loadu_si128((__m128i *) ptr);
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+        if (base == 16) {
+            __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+            digit = _mm_or_si128(digit,
+                        _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1))));
+        }
+        if (sign) {
+            digit = _mm_or_si128(digit, _mm_cmpeq_epi8(v, _mm_set1_epi8('-')));
+        }
+        return (uint32_t) _mm_movemask_epi8(digit);
+#else
+        swar_t x = ((unaligned_swar_t *) ptr)->word;
+        swar_t low7 = x & SWAR_ONES * 0x7F;
+        swar_t digit = SWAR_BETWEEN(low7, '0' - 1, '9' + 1);
+        if (base == 16) {
+            digit |= SWAR_BETWEEN(low7 | SWAR_ONES * 0x20, 'a' - 1, 'f' + 1);
+        }
+        if (sign) {
+            digit |= SWAR_BETWEEN(low7, '-' - 1, '-' + 1);
+        }
+        digit &= ~x;  // bytes >= 0x80 are never digits
+        for (size_t i = 0; i < SWAR_CHARS; i++) {
+            mask |= (uint32_t)((digit >> (8 * i + 7)) & 1u) << i;
+        }
+        return mask;
+#endif
+    }
+
+    for (size_t i = 0; i < STREAM_BLOCK; i++) {
+        mask |= (uint32_t)(digit_value(*(ptr + i)) < base ||
+                           (sign && *(ptr + i) == '-')) << i;
+    }
+    return mask;
+}
+
+/* Number of leading bytes at `ptr` that are digits in `base` */
+static size_t stream_digit_run(uint8_t * ptr, size_t length, uint32_t base) {
+    size_t run = 0;
+
+    while (length - run >= STREAM_BLOCK) {
+        uint32_t stop = ~stream_digit_mask(ptr + run, base, 0) &
+                        (uint32_t)((1ull << STREAM_BLOCK) - 1);
+        if (stop) {
+            return run + DATA_CTZ(stop);
+        }
+        run += STREAM_BLOCK;
+    }
+    while (run < length && digit_value(*(ptr + run)) < base) {
+        run++;
+    }
+    return run;
+}
+
+/* Number of leading bytes at `ptr` that can neither start nor continue a token */
+static size_t stream_skip_delimiters(uint8_t * ptr, size_t length,
+                                     uint32_t base) {
+    size_t skip = 0;
+
+    while (length - skip >= STREAM_BLOCK) {
+        uint32_t start = stream_digit_mask(ptr + skip, base, 1);
+        if (start) {
+            return skip + DATA_CTZ(start);
+        }
+        skip += STREAM_BLOCK;
+    }
+    while (skip < length && *(ptr + skip) != '-' &&
+           digit_value(*(ptr + skip)) >= base) {
+        skip++;
+    }
+    return skip;
+}
+
+/*
+ * Appends `run` known-valid digits at `ptr` to the pending token. The
+ * magnitude wraps like my_atoi(), and `overflow` records that it has
+ * left 32 bits so the uint8 clamp still sees an out-of-range value.
+ */
+static void stream_accumulate(atoi_stream_t * stream, uint8_t * ptr,
+                              size_t run) {
+    uint32_t value = stream->value;
+    int overflow = 0;
+
+    if (stream->base == 10) {
+        for (; run >= SWAR_CHARS; run -= SWAR_CHARS, ptr += SWAR_CHARS) {
+            uint32_t chunk = swar_decimal_accumulate(0,
+                                 ((unaligned_swar_t *) ptr)->word);
+            overflow |= __builtin_mul_overflow(value, SWAR_DECIMAL_SCALE, &value) |
+                        __builtin_add_overflow(value, chunk, &value);
+        }
+    } else if (stream->base == 16) {
+        for (; run >= SWAR_CHARS; run -= SWAR_CHARS, ptr += SWAR_CHARS) {
+            overflow |= (value >> (32 - 4 * SWAR_CHARS)) != 0;
+            value = swar_hex_accumulate(value, ((unaligned_swar_t *) ptr)->word);
+        }
+    }
+    while (run--) {
+        overflow |= __builtin_mul_overflow(value, stream->base, &value) |
+                    __builtin_add_overflow(value, digit_value(*ptr++), &value);
+    }
+
+    stream->value = value;
+    stream->overflow |= (uint8_t) overflow;
+}
 
-        if (c >= '0' && c <= '9') {
-            value = c - '0';
-        } else if (c >= 'A' && c <= 'F') {
-            value = c - 'A' + 10;
-        } else if (c >= 'a' && c <= 'f') {
-            value = c - 'a' + 10;
+/*
+ * Stores the pending token, if it has any digits, and resets the token
+ * state. Returns 0 and keeps the token pending if the output is full.
+ */
+static int stream_emit(atoi_stream_t * stream) {
+    if (stream->has_digits) {
+        uint32_t value = stream->value;
+        if (stream->count == stream->out_cap) {
+            return 0;
+        }
+        if (stream->out_i32) {
+            *(stream->out_i32 + stream->count) =
+                (int32_t)(stream->is_negative ? 0u - value : value);
         } else {
-            return 0; // Invalid character
+            *(stream->out_u8 + stream->count) =
+                stream->is_negative ? 0 :
+                (stream->overflow || value > 0xFF ? 0xFF : (uint8_t) value);
+        }
+        stream->count++;
+    }
+    stream->value = 0;
+    stream->in_token = 0;
+    stream->has_digits = 0;
+    stream->is_negative = 0;
+    stream->overflow = 0;
+    return 1;
+}
+
+void atoi_stream_init(atoi_stream_t * stream, uint32_t base) {
+    stream->base = base;
+    stream->value = 0;
+    stream->in_token = 0;
+    stream->has_digits = 0;
+    stream->is_negative = 0;
+    stream->overflow = 0;
+    stream->out_i32 = NULL;
+    stream->out_u8 = NULL;
+    stream->out_cap = 0;
+    stream->count = 0;
+}
+
+void atoi_stream_output_i32(atoi_stream_t * stream, int32_t * out,
+                            size_t out_cap) {
+    stream->out_i32 = out;
+    stream->out_u8 = NULL;
+    stream->out_cap = out_cap;
+    stream->count = 0;
+}
+
+void atoi_stream_output_u8(atoi_stream_t * stream, uint8_t * out,
+                           size_t out_cap) {
+    stream->out_i32 = NULL;
+    stream->out_u8 = out;
+    stream->out_cap = out_cap;
+    stream->count = 0;
+}
+
+size_t atoi_stream_feed(atoi_stream_t * stream, uint8_t * chunk,
+                        size_t length) {
+    size_t pos = 0;
+
+    while (pos < length) {
+        if (stream->in_token) {
+            size_t run = stream_digit_run(chunk + pos, length - pos,
+                                          stream->base);
+            if (run > 0) {
+                stream_accumulate(stream, chunk + pos, run);
+                stream->has_digits = 1;
+                pos += run;
+            }
+            if (pos == length) {
+                break;  // The token may continue in the next chunk
+            }
+            if (!stream_emit(stream)) {
+                return pos;
+            }
+        }
+
+        pos += stream_skip_delimiters(chunk + pos, length - pos, stream->base);
+        if (pos == length) {
+            break;
+        }
+        stream->in_token = 1;
+        if (*(chunk + pos) == '-') {
+            stream->is_negative = 1;
+            pos++;
+        }
+    }
+    return pos;
+}
+
+size_t atoi_stream_finish(atoi_stream_t * stream) {
+    if (stream->in_token) {
+        stream_emit(stream);
+    }
+    return stream->count;
+}
+
+/*
+ * Turns SWAR_CHARS / 2 bytes (first in the lowest byte) into hex digits,
+ * first character in the lowest byte: each byte is spread into its own
+ * 16-bit lane, split into nibbles and all lanes are mapped to ASCII at
+ * once ('0' + n, plus 7 for n >= 10).
+ */
+static inline swar_t swar_hex_chars(uint32_t bytes) {
+    swar_t x = bytes;
+    swar_t nibbles = SWAR_ONES / 0x0101 * 0x000F;
+
+#if !defined (MSP432)
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+#endif
+    x = (x | (x << 8)) & (SWAR_ONES / 0x0101 * 0x00FF);
+    x = ((x >> 4) & nibbles) | ((x & nibbles) << 8);
+    return x + SWAR_ONES * '0' + (((x + SWAR_ONES * 6) >> 4) & SWAR_ONES) * 7;
+}
+
+size_t hex_encode(uint8_t * src, size_t length, uint8_t * dst) {
+    uint8_t * end = src + length;
+
+#if defined (HOST) && defined (__SSE2__)
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero_char = _mm_set1_epi8('0');
+    const __m128i letter_gap = _mm_set1_epi8('A' - '9' - 1);
+
+    for (; end - src >= 16; src += 16, dst += 32) {
+        __m128i v = _mm_loadu_si128((__m128i *) src);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+        __m128i lo = _mm_and_si128(v, nibble);
+        __m128i a = _mm_unpacklo_epi8(hi, lo);
+        __m128i b = _mm_unpackhi_epi8(hi, lo);
+
+        a = _mm_add_epi8(_mm_add_epi8(a, zero_char),
+                         _mm_and_si128(_mm_cmpgt_epi8(a, nine), letter_gap));
+        b = _mm_add_epi8(_mm_add_epi8(b, zero_char),
+                         _mm_and_si128(_mm_cmpgt_epi8(b, nine), letter_gap));
+        _mm_storeu_si128((__m128i *) dst, a);
+        _mm_storeu_si128((__m128i *)(dst + 16), b);
+    }
+#endif
+    for (; (size_t)(end - src) >= SWAR_CHARS / 2;
+         src += SWAR_CHARS / 2, dst += SWAR_CHARS) {
+        uint32_t bytes = 0;
+        for (uint32_t i = 0; i < SWAR_CHARS / 2; i++) {
+            bytes |= (uint32_t) *(src + i) << (8 * i);
+        }
+        ((unaligned_swar_t *) dst)->word = swar_hex_chars(bytes);
+    }
+    for (; src < end; src++) {
+        *dst++ = *(digit_chars + (*src >> 4));
+        *dst++ = *(digit_chars + (*src & 0x0F));
+    }
+    return 2 * length;
+}
+
+#if defined (HOST) && defined (__SSE2__)
+/*
+ * Converts 16 hex digits to nibble values, or returns 0 if any of them is
+ * not a hex digit. Digits and letters are told apart with unsigned range
+ * checks (x - lo <= hi - lo) done as min-and-compare.
+ */
+static inline int sse_hex_nibbles(__m128i c, __m128i * values) {
+    __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)),
+                                  _mm_set1_epi8('a'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)),
+                                      digit);
+    __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)),
+                                       letter);
+
+    *values = _mm_or_si128(_mm_and_si128(is_digit, digit),
+                           _mm_and_si128(is_letter,
+                                         _mm_add_epi8(letter,
+                                                      _mm_set1_epi8(10))));
+    return _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) == 0xFFFF;
+}
+#endif
+
+size_t hex_decode(uint8_t * src, size_t length, uint8_t * dst) {
+    uint8_t * end = src + length;
+
+    if (length % 2) {
+        return DATA_DECODE_ERROR;
+    }
+
+#if defined (HOST) && defined (__SSE2__)
+    for (; end - src >= 32; src += 32, dst += 16) {
+        __m128i a;
+        __m128i b;
+        if (!sse_hex_nibbles(_mm_loadu_si128((__m128i *) src), &a) ||
+            !sse_hex_nibbles(_mm_loadu_si128((__m128i *)(src + 16)), &b)) {
+            return DATA_DECODE_ERROR;
+        }
+        /* High nibble in the low byte of each 16-bit lane */
+        a = _mm_or_si128(_mm_slli_epi16(a, 4), _mm_srli_epi16(a, 8));
+        b = _mm_or_si128(_mm_slli_epi16(b, 4), _mm_srli_epi16(b, 8));
+        a = _mm_and_si128(a, _mm_set1_epi16(0x00FF));
+        b = _mm_and_si128(b, _mm_set1_epi16(0x00FF));
+        _mm_storeu_si128((__m128i *) dst, _mm_packus_epi16(a, b));
+    }
+#endif
+    for (; (size_t)(end - src) >= SWAR_CHARS;
+         src += SWAR_CHARS, dst += SWAR_CHARS / 2) {
+        swar_t x = ((unaligned_swar_t *) src)->word;
+        uint32_t bytes;
+        if (!swar_all_hex(x)) {
+            return DATA_DECODE_ERROR;
+        }
+        bytes = swar_hex_bytes(x);
+        for (uint32_t i = 0; i < SWAR_CHARS / 2; i++) {
+            *(dst + i) = (uint8_t)(bytes >> (8 * i));
+        }
+    }
+    for (; src < end; src += 2) {
+        uint8_t hi = digit_value(*src);
+        uint8_t lo = digit_value(*(src + 1));
+        if (hi > 15 || lo > 15) {
+            return DATA_DECODE_ERROR;
+        }
+        *dst++ = (uint8_t)((hi << 4) | lo);
+    }
+    return length / 2;
+}
+
+static const uint8_t base64_chars[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Value of every byte as a base64 digit, 0xFF if it is not one */
+#define BASE64_VALUE(c) \
+    ((c) >= 'A' && (c) <= 'Z' ? (c) - 'A' : \
+     (c) >= 'a' && (c) <= 'z' ? (c) - 'a' + 26 : \
+     (c) >= '0' && (c) <= '9' ? (c) - '0' + 52 : \
+     (c) == '+' ? 62 : (c) == '/' ? 63 : 0xFF)
+#define BASE64_VALUES4(n)  BASE64_VALUE(n), BASE64_VALUE(n + 1), \
+                           BASE64_VALUE(n + 2), BASE64_VALUE(n + 3)
+#define BASE64_VALUES16(n) BASE64_VALUES4(n), BASE64_VALUES4(n + 4), \
+                           BASE64_VALUES4(n + 8), BASE64_VALUES4(n + 12)
+#define BASE64_VALUES64(n) BASE64_VALUES16(n), BASE64_VALUES16(n + 16), \
+                           BASE64_VALUES16(n + 32), BASE64_VALUES16(n + 48)
+static const uint8_t base64_values[256] = {
+    BASE64_VALUES64(0), BASE64_VALUES64(64), BASE64_VALUES64(128),
+    BASE64_VALUES64(192)
+};
+
+/*
+ * Maps four 6-bit values, one per byte lane, to base64 characters with
+ * per-lane range flags instead of a table lookup: 'A' + v, then +6 from
+ * 26 ('a'), -75 from 52 ('0'), -15 at 62 ('+') and +3 at 63 ('/'). The
+ * lanes never carry or borrow into each other.
+ */
+static inline uint32_t swar_base64_chars(uint32_t v) {
+    uint32_t ones = 0x01010101u;
+    uint32_t ge26 = ((v + ones * (128 - 26)) >> 7) & ones;
+    uint32_t ge52 = ((v + ones * (128 - 52)) >> 7) & ones;
+    uint32_t ge62 = ((v + ones * (128 - 62)) >> 7) & ones;
+    uint32_t ge63 = ((v + ones * (128 - 63)) >> 7) & ones;
+
+    return v + ones * 'A' + ge26 * 6 - ge52 * 75 - ge62 * 15 + ge63 * 3;
+}
+
+#if defined (HOST) && defined (__SSSE3__)
+/*
+ * Encodes 12 bytes at `src` (16 are read) into 16 characters: PSHUFB
+ * gathers each 3-byte group into a 32-bit lane, multiplies move the four
+ * 6-bit fields into their own bytes, and a second PSHUFB picks the ASCII
+ * offset for each value's range.
+ */
+static inline __m128i sse_base64_encode12(uint8_t * src) {
+    __m128i in = _mm_loadu_si128((__m128i *) src);
+    __m128i lo;
+    __m128i hi;
+    __m128i values;
+    __m128i range;
+
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                           4, 5, 3, 4, 1, 2, 0, 1));
+    hi = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)),
+                         _mm_set1_epi32(0x04000040));
+    lo = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)),
+                         _mm_set1_epi32(0x01000010));
+    values = _mm_or_si128(hi, lo);
+
+    /* 0: 'a'-'z', 1-10: digits, 11: '+', 12: '/', 13: 'A'-'Z' */
+    range = _mm_subs_epu8(values, _mm_set1_epi8(51));
+    range = _mm_or_si128(range,
+                         _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26),
+                                                      values),
+                                       _mm_set1_epi8(13)));
+    return _mm_add_epi8(values,
+        _mm_shuffle_epi8(_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                       '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                       '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                       '/' - 63, 'A', 0, 0), range));
+}
+
+/*
+ * Decodes 16 base64 characters at `src` into 12 bytes stored at `dst`
+ * (16 are written), or returns 0 if any of them is not a base64 digit.
+ * Validity comes from nibble-indexed class tables, the value from a
+ * per-class offset, and PMADDUBSW/PMADDWD pack the 6-bit fields.
+ */
+static inline int sse_base64_decode16(uint8_t * src, uint8_t * dst) {
+    __m128i in = _mm_loadu_si128((__m128i *) src);
+    __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4),
+                                       _mm_set1_epi8(0x0F));
+    __m128i lo_nibbles = _mm_and_si128(in, _mm_set1_epi8(0x0F));
+    __m128i lo_class = _mm_shuffle_epi8(
+        _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A),
+        lo_nibbles);
+    __m128i hi_class = _mm_shuffle_epi8(
+        _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10),
+        hi_nibbles);
+    __m128i is_slash;
+    __m128i values;
+
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo_class, hi_class),
+                                         _mm_setzero_si128()))) {
+        return 0;
+    }
+    is_slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+    values = _mm_add_epi8(in, _mm_shuffle_epi8(
+        _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                      0, 0, 0, 0, 0, 0, 0, 0),
+        _mm_add_epi8(is_slash, hi_nibbles)));
+
+    values = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    values = _mm_madd_epi16(values, _mm_set1_epi32(0x00011000));
+    values = _mm_shuffle_epi8(values, _mm_setr_epi8(2, 1, 0, 6, 5, 4,
+                                                    10, 9, 8, 14, 13, 12,
+                                                    -1, -1, -1, -1));
+    _mm_storeu_si128((__m128i *) dst, values);
+    return 1;
+}
+#endif
+
+size_t base64_encode(uint8_t * src, size_t length, uint8_t * dst) {
+    uint8_t * end = src + length;
+    uint8_t * start = dst;
+
+#if defined (HOST) && defined (__SSSE3__)
+    for (; end - src >= 16; src += 12, dst += 16) {
+        _mm_storeu_si128((__m128i *) dst, sse_base64_encode12(src));
+    }
+#endif
+    for (; end - src >= 3; src += 3, dst += 4) {
+        uint32_t group = ((uint32_t) *src << 16) |
+                         ((uint32_t) *(src + 1) << 8) | *(src + 2);
+        uint32_t values = (group >> 18) | (((group >> 12) & 0x3F) << 8) |
+                          (((group >> 6) & 0x3F) << 16) | ((group & 0x3F) << 24);
+        uint32_t chars = swar_base64_chars(values);
+        for (uint32_t i = 0; i < 4; i++) {
+            *(dst + i) = (uint8_t)(chars >> (8 * i));
+        }
+    }
+    if (end - src > 0) {
+        uint32_t group = (uint32_t) *src << 16;
+        if (end - src > 1) {
+            group |= (uint32_t) *(src + 1) << 8;
+        }
+        *dst++ = *(base64_chars + (group >> 18));
+        *dst++ = *(base64_chars + ((group >> 12) & 0x3F));
+        *dst++ = (end - src > 1) ? *(base64_chars + ((group >> 6) & 0x3F)) : '=';
+        *dst++ = '=';
+    }
+    return (size_t)(dst - start);
+}
+
+size_t base64_decode(uint8_t * src, size_t length, uint8_t * dst) {
+    uint8_t * end = src + length;
+    uint8_t * last = end;
+    uint8_t * start = dst;
+    size_t padding = 0;
+
+    if (length % 4) {
+        return DATA_DECODE_ERROR;
+    }
+    if (length > 0 && *(end - 1) == '=') {
+        padding = (*(end - 2) == '=') ? 2 : 1;
+        last = end - 4;
+    }
+
+#if defined (HOST) && defined (__SSSE3__)
+    /* 8 characters must follow each block to absorb the 4-byte overrun;
+     * they decode to at least 4 bytes even with padding */
+    for (; end - src >= 24; src += 16, dst += 12) {
+        if (!sse_base64_decode16(src, dst)) {
+            break;  // the scalar loop below reports the bad character
+        }
+    }
+#endif
+    for (; src < end; src += 4) {
+        uint32_t a = *(base64_values + *src);
+        uint32_t b = *(base64_values + *(src + 1));
+        uint32_t c = *(base64_values + *(src + 2));
+        uint32_t d = *(base64_values + *(src + 3));
+        uint32_t group;
+
+        if (src == last) {
+            /* "xx==" or "xxx=": the padding stands in for zero digits */
+            d = 0;
+            if (padding == 2) {
+                c = 0;
+            }
+        }
+        if ((a | b | c | d) > 63) {
+            return DATA_DECODE_ERROR;
+        }
+        group = (a << 18) | (b << 12) | (c << 6) | d;
+        *dst++ = (uint8_t)(group >> 16);
+        if (src == last) {
+            /* Only the bytes the padding leaves; nothing past them */
+            if (padding == 1) {
+                *dst++ = (uint8_t)(group >> 8);
+            }
+            break;
+        }
+        *dst++ = (uint8_t)(group >> 8);
+        *dst++ = (uint8_t) group;
+    }
+    return (size_t)(dst - start);
+}
+
+size_t hexdump(uint8_t * src, size_t length, uint32_t offset, uint8_t * dst) {
+    uint8_t * start = dst;
+
+    for (size_t line = 0; line < length; line += HEXDUMP_BYTES_PER_LINE) {
+        size_t count = length - line;
+        if (count > HEXDUMP_BYTES_PER_LINE) {
+            count = HEXDUMP_BYTES_PER_LINE;
+        }
+
+        /* "0000ABCD  " */
+        write_hex8(offset + (uint32_t) line, dst);
+        dst += 8;
+        *dst++ = ' ';
+        *dst++ = ' ';
+
+        /* "48 65 6C 6C 6F 20 77 6F  72 6C 64 ..." padded to full width */
+        for (size_t i = 0; i < HEXDUMP_BYTES_PER_LINE; i++) {
+            if (i < count) {
+                uint8_t byte = *(src + line + i);
+                *dst++ = *(digit_chars + (byte >> 4));
+                *dst++ = *(digit_chars + (byte & 0x0F));
+            } else {
+                *dst++ = ' ';
+                *dst++ = ' ';
+            }
+            *dst++ = ' ';
+            if (i == HEXDUMP_BYTES_PER_LINE / 2 - 1) {
+                *dst++ = ' ';
+            }
+        }
+
+        /* " |Hello world|" with non-printable bytes as '.' */
+        *dst++ = ' ';
+        *dst++ = '|';
+        for (size_t i = 0; i < count; i++) {
+            uint8_t byte = *(src + line + i);
+            *dst++ = (byte >= 0x20 && byte < 0x7F) ? byte : '.';
+        }
+        *dst++ = '|';
+        *dst++ = '\n';
+    }
+    return (size_t)(dst - start);
+}
+
+#if defined (MSP432)
+#define SWAR_CTZ(x) DATA_CTZ(x)
+#else
+#define SWAR_CTZ(x) __builtin_ctzll(x)
+#endif
+
+/* Zigzag mapping: 0, -1, 1, -2, ... to 0, 1, 2, 3, ... */
+static inline uint32_t zigzag_encode32(int32_t value) {
+    return ((uint32_t) value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t zigzag_decode32(uint32_t value) {
+    return (int32_t)((value >> 1) ^ (0u - (value & 1)));
+}
+
+static inline uint64_t zigzag_encode64(int64_t value) {
+    return ((uint64_t) value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t zigzag_decode64(uint64_t value) {
+    return (int64_t)((value >> 1) ^ (0ull - (value & 1)));
+}
+
+/* ceil(bits / 7) as (bits * 9 + 64) / 64, exact for 1 to 64 bits */
+static inline size_t varint_length32(uint32_t value) {
+    return ((32 - DATA_CLZ(value | 1)) * 9 + 64) / 64;
+}
+
+static inline size_t varint_length64(uint64_t value) {
+    return ((64 - clz64(value | 1)) * 9 + 64) / 64;
+}
+
+static inline size_t varint_write(uint64_t value, uint8_t * dst) {
+    uint8_t * start = dst;
+
+    while (value >= 0x80) {
+        *dst++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *dst++ = (uint8_t) value;
+    return (size_t)(dst - start);
+}
+
+/*
+ * Joins the 7-bit groups held in the bytes of `x` (first group in the
+ * lowest byte) into one value: pairs, then quads, then octets of groups
+ * are merged by closing the gaps the continuation bits leave.
+ */
+static inline uint64_t swar_varint_bits(swar_t x) {
+    x &= SWAR_ONES * 0x7F;
+#if defined (MSP432)
+    x = ((x & 0x7F007F00u) >> 1) | (x & 0x007F007Fu);
+    x = ((x & 0x3FFF0000u) >> 2) | (x & 0x00003FFFu);
+#else
+    x = ((x & 0x7F007F007F007F00ull) >> 1) | (x & 0x007F007F007F007Full);
+    x = ((x & 0x3FFF00003FFF0000ull) >> 2) | (x & 0x00003FFF00003FFFull);
+    x = ((x & 0x0FFFFFFF00000000ull) >> 4) | (x & 0x000000000FFFFFFFull);
+#endif
+    return x;
+}
+
+/*
+ * Reads one varint of at most `max_bytes` bytes from the `avail` bytes at
+ * `src`. Returns its length, or 0 if it is cut off or longer than
+ * `max_bytes`. When a whole register word is available the terminating
+ * byte is found with one mask and CTZ, and the groups are joined with
+ * swar_varint_bits() instead of a byte loop.
+ */
+static inline size_t varint_read(uint8_t * src, size_t avail,
+                                 size_t max_bytes, uint64_t * value) {
+    uint64_t result = 0;
+
+    if (avail >= SWAR_CHARS) {
+        swar_t x = ((unaligned_swar_t *) src)->word;
+        swar_t stop = ~x & SWAR_ONES * 0x80;
+        if (stop) {
+            size_t length = SWAR_CTZ(stop) / 8 + 1;
+            if (length > max_bytes) {
+                return 0;
+            }
+            *value = swar_varint_bits(x & (stop ^ (stop - 1)));
+            return length;
+        }
+    }
+
+    for (size_t i = 0; i < max_bytes && i < avail; i++) {
+        uint8_t byte = *(src + i);
+        result |= (uint64_t)(byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80)) {
+            if (i == VARINT64_MAX_BYTES - 1 && byte > 1) {
+                return 0;  // more than 64 bits
+            }
+            *value = result;
+            return i + 1;
         }
+    }
+    return 0;
+}
+
+size_t varint_size32(int32_t * values, size_t n) {
+    size_t total = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        total += varint_length32(zigzag_encode32(*(values + i)));
+    }
+    return total;
+}
+
+size_t varint_size64(int64_t * values, size_t n) {
+    size_t total = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        total += varint_length64(zigzag_encode64(*(values + i)));
+    }
+    return total;
+}
+
+size_t varint_encode32(int32_t * values, size_t n, uint8_t * dst) {
+    uint8_t * start = dst;
+
+    for (size_t i = 0; i < n; i++) {
+        dst += varint_write(zigzag_encode32(*(values + i)), dst);
+    }
+    return (size_t)(dst - start);
+}
+
+size_t varint_encode64(int64_t * values, size_t n, uint8_t * dst) {
+    uint8_t * start = dst;
+
+    for (size_t i = 0; i < n; i++) {
+        dst += varint_write(zigzag_encode64(*(values + i)), dst);
+    }
+    return (size_t)(dst - start);
+}
+
+size_t varint_decode32(uint8_t * src, size_t length, int32_t * values,
+                       size_t n) {
+    uint8_t * end = src + length;
+    size_t count = 0;
 
-        result = result * base + value;
+    while (count < n && src < end) {
+        uint64_t value;
+        size_t used;
+
+#if defined (HOST) && defined (__SSE2__)
+        /* Runs of 16 one-byte values: widen and unzigzag in registers */
+        if (n - count >= 16 && end - src >= 16) {
+            __m128i v = _mm_loadu_si128((__m128i *) src);
+            if (_mm_movemask_epi8(v) == 0) {
+                __m128i zero = _mm_setzero_si128();
+                __m128i one = _mm_set1_epi32(1);
+                __m128i lo = _mm_unpacklo_epi8(v, zero);
+                __m128i hi = _mm_unpackhi_epi8(v, zero);
+                __m128i w[4];
+                w[0] = _mm_unpacklo_epi16(lo, zero);
+                w[1] = _mm_unpackhi_epi16(lo, zero);
+                w[2] = _mm_unpacklo_epi16(hi, zero);
+                w[3] = _mm_unpackhi_epi16(hi, zero);
+                for (int i = 0; i < 4; i++) {
+                    __m128i sign = _mm_sub_epi32(zero, _mm_and_si128(w[i], one));
+                    _mm_storeu_si128((__m128i *)(values + count + 4 * i),
+                                     _mm_xor_si128(_mm_srli_epi32(w[i], 1),
+                                                   sign));
+                }
+                src += 16;
+                count += 16;
+                continue;
+            }
+        }
+#endif
+        used = varint_read(src, (size_t)(end - src), VARINT32_MAX_BYTES,
+                           &value);
+        if (used == 0 || (value >> 32) != 0) {
+            return DATA_DECODE_ERROR;
+        }
+        *(values + count++) = zigzag_decode32((uint32_t) value);
+        src += used;
     }
+    return count;
+}
 
-    return is_negative ? -result : result;
+size_t varint_decode64(uint8_t * src, size_t length, int64_t * values,
+                       size_t n) {
+    uint8_t * end = src + length;
+    size_t count = 0;
+
+    while (count < n && src < end) {
+        uint64_t value;
+        size_t used = varint_read(src, (size_t)(end - src), VARINT64_MAX_BYTES,
+                                  &value);
+        if (used == 0) {
+            return DATA_DECODE_ERROR;
+        }
+        *(values + count++) = zigzag_decode64(value);
+        src += used;
+    }
+    return count;
 }
@@ -0,0 +1,182 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are 
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material. 
+ *
+ *****************************************************************************/
+/**
+ * @file dlog.c
+ * @brief Implementation of deferred binary logging
+ *
+ * Writers reserve space by advancing the head with a compare-and-swap
+ * (LDREX/STREX on the target), store their argument words and then the
+ * header word. The reader takes a record only once its header is set,
+ * and zeroes every word it consumes so an unwritten header always reads
+ * as zero.
+ *
+ * @author
+ * @date
+ *
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include "dlog.h"
+#include "platform.h"
+
+#if defined (HOST) && (defined (__unix__) || defined (__APPLE__))
+#include <errno.h>
+#include <unistd.h>
+#define DLOG_USE_STDERR
+#endif
+
+#define DLOG_MASK (DLOG_BUFFER_WORDS - 1)
+
+/* Words passed to the sink per call by dlog_flush() */
+#define DLOG_FLUSH_CHUNK_W (32)
+
+static volatile uint32_t dlog_ring[DLOG_BUFFER_WORDS];
+static volatile uint32_t dlog_head;   /* Total words reserved by writers */
+static volatile uint32_t dlog_tail;   /* Total words removed by the reader */
+static volatile uint32_t dlog_drops;  /* Records lost to a full ring */
+
+static inline uint32_t dlog_load_linked(volatile uint32_t * word) {
+#if defined (MSP432)
+    return __LDREXW(word);
+#else
+    return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline int dlog_store_conditional(volatile uint32_t * word,
+                                         uint32_t expected, uint32_t value) {
+#if defined (MSP432)
+    (void) expected;
+    return __STREXW(value, word) == 0;
+#else
+    return __atomic_compare_exchange_n(word, &expected, value, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void dlog_abandon_linked(void) {
+#if defined (MSP432)
+    __CLREX();
+#endif
+}
+
+/* Plain loads and stores that order the ring words against the indexes */
+static inline uint32_t dlog_load(volatile uint32_t * word) {
+#if defined (MSP432)
+    return *word;  // single core: program order is enough
+#else
+    return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void dlog_store(volatile uint32_t * word, uint32_t value) {
+#if defined (MSP432)
+    *word = value;
+#else
+    __atomic_store_n(word, value, __ATOMIC_RELEASE);
+#endif
+}
+
+void dlog_write(uint32_t id, uint32_t count, uint32_t a0, uint32_t a1,
+                uint32_t a2, uint32_t a3) {
+    uint32_t head;
+    uint32_t drops;
+
+    do {
+        head = dlog_load_linked(&dlog_head);
+        if (head - dlog_load(&dlog_tail) + count + 1 > DLOG_BUFFER_WORDS) {
+            dlog_abandon_linked();
+            do {
+                drops = dlog_load_linked(&dlog_drops);
+            } while (!dlog_store_conditional(&dlog_drops, drops, drops + 1));
+            return;
+        }
+    } while (!dlog_store_conditional(&dlog_head, head, head + count + 1));
+
+    /* Arguments first; the header publishes the record */
+    if (count > 0) *(dlog_ring + ((head + 1) & DLOG_MASK)) = a0;
+    if (count > 1) *(dlog_ring + ((head + 2) & DLOG_MASK)) = a1;
+    if (count > 2) *(dlog_ring + ((head + 3) & DLOG_MASK)) = a2;
+    if (count > 3) *(dlog_ring + ((head + 4) & DLOG_MASK)) = a3;
+    dlog_store(dlog_ring + (head & DLOG_MASK), DLOG_HEADER(id, count));
+}
+
+size_t dlog_read(uint32_t * dst, size_t max_words) {
+    uint32_t tail = dlog_tail;
+    size_t copied = 0;
+
+    while (tail != dlog_load(&dlog_head)) {
+        uint32_t header = dlog_load(dlog_ring + (tail & DLOG_MASK));
+        uint32_t words;
+
+        if (!DLOG_HEADER_VALID(header)) {
+            break;  // reserved but not yet written
+        }
+        words = DLOG_HEADER_COUNT(header) + 1;
+        if (copied + words > max_words) {
+            break;
+        }
+        for (uint32_t i = 0; i < words; i++) {
+            *(dst + copied + i) = *(dlog_ring + ((tail + i) & DLOG_MASK));
+            *(dlog_ring + ((tail + i) & DLOG_MASK)) = 0;
+        }
+        copied += words;
+        tail += words;
+        dlog_store(&dlog_tail, tail);
+    }
+    return copied;
+}
+
+/* Default sink when none is given */
+static size_t dlog_default_sink(uint8_t * data, size_t length) {
+#if defined (DLOG_USE_STDERR)
+    ssize_t written;
+
+    do {
+        written = write(STDERR_FILENO, data, length);
+    } while (written < 0 && errno == EINTR);
+    return (written > 0) ? (size_t) written : 0;
+#elif defined (HOST)
+    return fwrite(data, 1, length, stderr);
+#else
+    (void) data;
+    return length;  // no console on the target: discard
+#endif
+}
+
+size_t dlog_flush(output_sink_t sink) {
+    uint32_t chunk[DLOG_FLUSH_CHUNK_W];
+    size_t total = 0;
+    size_t words;
+
+    if (!sink) {
+        sink = dlog_default_sink;
+    }
+    while ((words = dlog_read(chunk, DLOG_FLUSH_CHUNK_W)) > 0) {
+        uint8_t * data = (uint8_t *) chunk;
+        size_t length = words * sizeof(uint32_t);
+
+        total += words;
+        while (length > 0) {
+            size_t accepted = sink(data, length);
+            if (accepted == 0) {
+                return total;  // sink stalled: the rest of the chunk is lost
+            }
+            data += accepted;
+            length -= accepted;
+        }
+    }
+    return total;
+}
+
+uint32_t dlog_dropped(void) {
+    return dlog_load(&dlog_drops);
+}
@@ -20,16 +20,205 @@
  * @date
  *
  */
+#if defined (HOST) && defined (__linux__)
+#define _GNU_SOURCE  // For mremap
+#endif
 #include <stdlib.h>  // For malloc and free
 #include <stdint.h>
 #include <stddef.h>
 #include <stdio.h>
+#include "memory.h"
+#include "platform.h"
 
+#if defined (HOST) && defined (__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define WORD_VECTOR_USE_MREMAP
+#endif
+
+/* Storage locations of a word_vector_t */
+#define WORD_VECTOR_INLINE (0)
+#define WORD_VECTOR_HEAP   (1)
+#define WORD_VECTOR_MAPPED (2)
+
+#if defined (HOST) && defined (__SSE2__)
+#include <emmintrin.h>
+#define MEMDIFF_BLOCK (16)  /* One SSE2 vector per comparison */
+#else
+#define MEMDIFF_BLOCK (4)   /* One 32-bit word per comparison */
+#endif
+
+#define MEMDIFF_BLOCK_MASK ((uint32_t)((1ULL << MEMDIFF_BLOCK) - 1))
+
+#if defined (HOST) && defined (__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined (HOST) && defined (__AVX512BITALG__) && defined (__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+/* Native register width used by the SWAR bit kernels */
+#if defined (MSP432)
+typedef uint32_t bitword_t;
+#define BITWORD_ONES ((bitword_t) 0x01010101u)
+#else
+typedef uint64_t bitword_t;
+#define BITWORD_ONES ((bitword_t) 0x0101010101010101ull)
+#endif
+
+typedef struct __attribute__((packed)) {
+    bitword_t word;
+} unaligned_bitword_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t half;
+} unaligned_half_t;
+
+/* Bit-reversed value of every byte, used for heads and tails */
+#define BITREV2(n) n, n + 2 * 64, n + 1 * 64, n + 3 * 64
+#define BITREV4(n) BITREV2(n), BITREV2(n + 2 * 16), BITREV2(n + 1 * 16), \
+                   BITREV2(n + 3 * 16)
+#define BITREV6(n) BITREV4(n), BITREV4(n + 2 * 4), BITREV4(n + 1 * 4), \
+                   BITREV4(n + 3 * 4)
+static const uint8_t bitreverse_table[256] = {
+    BITREV6(0), BITREV6(2), BITREV6(1), BITREV6(3)
+};
+
+/* Largest length handled by the straight-line small-size paths */
+#define SMALL_MOVE_MAX (64)
+
+/* Small-size helpers are inlined even at -O0 so each caller gets its own
+ * branch tree and no call */
+#define SMALL_INLINE static inline __attribute__((always_inline))
+
+/* Widest block the small-size paths move in one load and store */
+#if defined (HOST) && defined (__SSE2__)
+typedef __m128i small_block_t;
+#define SMALL_LOAD(p)     _mm_loadu_si128((__m128i *)(p))
+#define SMALL_STORE(p, v) _mm_storeu_si128((__m128i *)(p), (v))
+#define SMALL_FILL(value) _mm_set1_epi8((char)(value))
+#else
+typedef bitword_t small_block_t;
+#define SMALL_LOAD(p)     (((unaligned_bitword_t *)(p))->word)
+#define SMALL_STORE(p, v) (((unaligned_bitword_t *)(p))->word = (v))
+#define SMALL_FILL(value) (BITWORD_ONES * (value))
+#endif
+#define SMALL_BLOCK (sizeof(small_block_t))
+
+/*
+ * Moves `length` bytes as `blocks` blocks from the start and `blocks`
+ * blocks from the end, which may overlap in the middle. Every load happens
+ * before the first store, so overlapping buffers are handled.
+ */
+SMALL_INLINE void small_move_blocks(uint8_t * src, uint8_t * dst,
+                                    size_t length, size_t blocks) {
+    small_block_t head[SMALL_MOVE_MAX / 2 / SMALL_BLOCK];
+    small_block_t tail[SMALL_MOVE_MAX / 2 / SMALL_BLOCK];
+    size_t last = length - blocks * SMALL_BLOCK;
+
+    for (size_t i = 0; i < blocks; i++) {
+        *(head + i) = SMALL_LOAD(src + i * SMALL_BLOCK);
+        *(tail + i) = SMALL_LOAD(src + last + i * SMALL_BLOCK);
+    }
+    for (size_t i = 0; i < blocks; i++) {
+        SMALL_STORE(dst + i * SMALL_BLOCK, *(head + i));
+        SMALL_STORE(dst + last + i * SMALL_BLOCK, *(tail + i));
+    }
+}
+
+/* Same as small_move_blocks() with native words, for 9 to 16 bytes */
+SMALL_INLINE void small_move_words(uint8_t * src, uint8_t * dst,
+                                   size_t length) {
+    bitword_t head[8 / sizeof(bitword_t)];
+    bitword_t tail[8 / sizeof(bitword_t)];
+    size_t last = length - 8;
+
+    for (size_t i = 0; i < 8 / sizeof(bitword_t); i++) {
+        *(head + i) = ((unaligned_bitword_t *)(src + i * sizeof(bitword_t)))->word;
+        *(tail + i) = ((unaligned_bitword_t *)(src + last + i * sizeof(bitword_t)))->word;
+    }
+    for (size_t i = 0; i < 8 / sizeof(bitword_t); i++) {
+        ((unaligned_bitword_t *)(dst + i * sizeof(bitword_t)))->word = *(head + i);
+        ((unaligned_bitword_t *)(dst + last + i * sizeof(bitword_t)))->word = *(tail + i);
+    }
+}
+
+/*
+ * Moves up to SMALL_MOVE_MAX bytes without a byte loop. The length picks
+ * a range, 0-1, 2-3, 4-8, 9-16, 17-32 or 33-64, shortest first so the
+ * tiny calls pay the fewest compares, and each range is covered by a head
+ * and a tail block that may overlap.
+ */
+SMALL_INLINE void small_move(uint8_t * src, uint8_t * dst, size_t length) {
+    if (length < 2) {
+        if (length) {
+            *dst = *src;
+        }
+    } else if (length < 4) {
+        uint16_t a = ((unaligned_half_t *) src)->half;
+        uint16_t b = ((unaligned_half_t *)(src + length - 2))->half;
+        ((unaligned_half_t *) dst)->half = a;
+        ((unaligned_half_t *)(dst + length - 2))->half = b;
+    } else if (length <= 8) {
+        uint32_t a = ((unaligned_word_t *) src)->word;
+        uint32_t b = ((unaligned_word_t *)(src + length - 4))->word;
+        ((unaligned_word_t *) dst)->word = a;
+        ((unaligned_word_t *)(dst + length - 4))->word = b;
+    } else if (length <= 16) {
+        small_move_words(src, dst, length);
+    } else if (length <= 32) {
+        small_move_blocks(src, dst, length, 16 / SMALL_BLOCK);
+    } else {
+        small_move_blocks(src, dst, length, 32 / SMALL_BLOCK);
+    }
+}
+
+/* Stores `blocks` blocks of `fill` at each end of a `length` byte range */
+SMALL_INLINE void small_set_blocks(uint8_t * dst, size_t length,
+                                   size_t blocks, small_block_t fill) {
+    size_t last = length - blocks * SMALL_BLOCK;
+
+    for (size_t i = 0; i < blocks; i++) {
+        SMALL_STORE(dst + i * SMALL_BLOCK, fill);
+        SMALL_STORE(dst + last + i * SMALL_BLOCK, fill);
+    }
+}
+
+/* Sets up to SMALL_MOVE_MAX bytes using the same ranges as small_move() */
+SMALL_INLINE void small_set(uint8_t * dst, size_t length, uint8_t value) {
+    bitword_t fill = BITWORD_ONES * value;
+
+    if (length < 2) {
+        if (length) {
+            *dst = value;
+        }
+    } else if (length < 4) {
+        ((unaligned_half_t *) dst)->half = (uint16_t) fill;
+        ((unaligned_half_t *)(dst + length - 2))->half = (uint16_t) fill;
+    } else if (length <= 8) {
+        ((unaligned_word_t *) dst)->word = (uint32_t) fill;
+        ((unaligned_word_t *)(dst + length - 4))->word = (uint32_t) fill;
+    } else if (length <= 16) {
+        for (size_t i = 0; i < 8 / sizeof(bitword_t); i++) {
+            ((unaligned_bitword_t *)(dst + i * sizeof(bitword_t)))->word = fill;
+            ((unaligned_bitword_t *)(dst + length - 8 + i * sizeof(bitword_t)))->word = fill;
+        }
+    } else if (length <= 32) {
+        small_set_blocks(dst, length, 16 / SMALL_BLOCK, SMALL_FILL(value));
+    } else {
+        small_set_blocks(dst, length, 32 / SMALL_BLOCK, SMALL_FILL(value));
+    }
+}
 
 uint8_t * my_memmove(uint8_t * src, uint8_t * dst, size_t length) {
     uint8_t * ret = dst;  // Save original dst pointer
     if (src == dst || length == 0) return ret;
 
+    if (length <= SMALL_MOVE_MAX) {
+        small_move(src, dst, length);
+        return ret;
+    }
+
     if (dst > src && dst < src + length) {
         src += length - 1;
         dst += length - 1;
@@ -46,6 +235,10 @@ uint8_t * my_memmove(uint8_t * src, uint8_t * dst, size_t length) {
 
 uint8_t * my_memcopy(uint8_t * src, uint8_t * dst, size_t length) {
     uint8_t * ret = dst;
+    if (length <= SMALL_MOVE_MAX) {
+        small_move(src, dst, length);
+        return ret;
+    }
     while (length--) {
         *dst++ = *src++;
     }
@@ -54,6 +247,10 @@ uint8_t * my_memcopy(uint8_t * src, uint8_t * dst, size_t length) {
 
 uint8_t * my_memset(uint8_t * src, size_t length, uint8_t value) {
     uint8_t *ptr = src;
+    if (length <= SMALL_MOVE_MAX) {
+        small_set(src, length, value);
+        return src;
+    }
     while (length--) {
         *ptr++ = value;
     }
@@ -62,6 +259,10 @@ uint8_t * my_memset(uint8_t * src, size_t length, uint8_t value) {
 
 uint8_t * my_memzero(uint8_t * src, size_t length) {
     uint8_t *ptr = src;
+    if (length <= SMALL_MOVE_MAX) {
+        small_set(src, length, 0);
+        return src;
+    }
     while (length--) {
         *ptr++ = 0;
     }
@@ -97,6 +298,245 @@ uint8_t * my_reverse(uint8_t * src, size_t length) {
     return src;
 }
 
+/*
+ * Returns one bit per byte of the block starting at `a` and `b`, set where
+ * the bytes differ. Bit 0 corresponds to the lowest address.
+ */
+static inline uint32_t memdiff_block_mask(uint8_t * a, uint8_t * b) {
+#if MEMDIFF_BLOCK == 16
+    __m128i va = _mm_loadu_si128((__m128i *) a);
+    __m128i vb = _mm_loadu_si128((__m128i *) b);
+    return ~(uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb))
+           & MEMDIFF_BLOCK_MASK;
+#else
+    uint32_t x = ((unaligned_word_t *) a)->word ^ ((unaligned_word_t *) b)->word;
+
+    /* Fold each byte lane into its lowest bit, then gather the four bits */
+    x |= x >> 4;
+    x |= x >> 2;
+    x |= x >> 1;
+    x &= 0x01010101u;
+    return (x | (x >> 7) | (x >> 14) | (x >> 21)) & MEMDIFF_BLOCK_MASK;
+#endif
+}
+
+/*
+ * Records the run [start, end). Once the output is full the last range is
+ * stretched instead, so the reported ranges still cover every difference.
+ */
+static void memdiff_emit(mem_range_t * ranges, size_t max_ranges,
+                         size_t * count, size_t start, size_t end) {
+    if (*count < max_ranges) {
+        (ranges + *count)->offset = start;
+        (ranges + *count)->length = end - start;
+        (*count)++;
+    } else {
+        mem_range_t * last = ranges + max_ranges - 1;
+        last->length = end - last->offset;
+    }
+}
+
+size_t my_memdiff(uint8_t * a, uint8_t * b, size_t length,
+                  mem_range_t * ranges, size_t max_ranges) {
+    size_t count = 0;
+    size_t pos = 0;
+    size_t start = 0;
+    int in_run = 0;
+    int any_only = (ranges == NULL || max_ranges == 0);
+
+    while (pos < length) {
+        uint32_t mask;
+        size_t width;
+
+        if (length - pos >= MEMDIFF_BLOCK) {
+            mask = memdiff_block_mask(a + pos, b + pos);
+            width = MEMDIFF_BLOCK;
+        } else {
+            mask = (*(a + pos) != *(b + pos));
+            width = 1;
+        }
+
+        if (any_only) {
+            if (mask) return 1;
+        } else if (mask == 0) {
+            if (in_run) {
+                memdiff_emit(ranges, max_ranges, &count, start, pos);
+                in_run = 0;
+            }
+        } else if (width > 1 && mask == MEMDIFF_BLOCK_MASK) {
+            if (!in_run) {
+                start = pos;
+                in_run = 1;
+            }
+        } else {
+            /* Mixed block: walk the byte lanes */
+            for (size_t i = 0; i < width; i++) {
+                int differs = (mask >> i) & 1u;
+                if (differs && !in_run) {
+                    start = pos + i;
+                    in_run = 1;
+                } else if (!differs && in_run) {
+                    memdiff_emit(ranges, max_ranges, &count, start, pos + i);
+                    in_run = 0;
+                }
+            }
+        }
+        pos += width;
+    }
+
+    if (in_run) {
+        memdiff_emit(ranges, max_ranges, &count, start, length);
+    }
+    return count;
+}
+
+uint8_t * my_bitreverse(uint8_t * src, size_t length) {
+    uint8_t * ptr = src;
+
+#if defined (HOST) && defined (__SSSE3__)
+    const __m128i rev_lo = _mm_setr_epi8(0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0,
+                                         0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0,
+                                         0x30, 0xB0, 0x70, 0xF0);
+    const __m128i rev_hi = _mm_srli_epi16(rev_lo, 4);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    while (length >= 16) {
+        __m128i v = _mm_loadu_si128((__m128i *) ptr);
+        __m128i lo = _mm_and_si128(v, nibble);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+        v = _mm_or_si128(_mm_shuffle_epi8(rev_lo, lo),
+                         _mm_and_si128(_mm_shuffle_epi8(rev_hi, hi), nibble));
+        _mm_storeu_si128((__m128i *) ptr, v);
+        ptr += 16;
+        length -= 16;
+    }
+#endif
+
+    while (length >= sizeof(bitword_t)) {
+        bitword_t x = ((unaligned_bitword_t *) ptr)->word;
+#if defined (MSP432)
+        /* RBIT mirrors the whole word, REV puts the bytes back in place */
+        x = __REV(__RBIT(x));
+#else
+        x = ((x >> 1) & (BITWORD_ONES * 0x55)) | ((x & (BITWORD_ONES * 0x55)) << 1);
+        x = ((x >> 2) & (BITWORD_ONES * 0x33)) | ((x & (BITWORD_ONES * 0x33)) << 2);
+        x = ((x >> 4) & (BITWORD_ONES * 0x0F)) | ((x & (BITWORD_ONES * 0x0F)) << 4);
+#endif
+        ((unaligned_bitword_t *) ptr)->word = x;
+        ptr += sizeof(bitword_t);
+        length -= sizeof(bitword_t);
+    }
+
+    while (length--) {
+        *ptr = *(bitreverse_table + *ptr);
+        ptr++;
+    }
+    return src;
+}
+
+/* Number of set bits in each byte lane of `x`, one count per lane */
+static inline bitword_t popcount_lanes(bitword_t x) {
+    x = x - ((x >> 1) & (BITWORD_ONES * 0x55));
+    x = (x & (BITWORD_ONES * 0x33)) + ((x >> 2) & (BITWORD_ONES * 0x33));
+    return (x + (x >> 4)) & (BITWORD_ONES * 0x0F);
+}
+
+/* Sum of the byte lanes of `x` (each lane holding at most 255) */
+static inline size_t sum_lanes(bitword_t x) {
+#if defined (MSP432)
+    return __USADA8(x, 0, 0);
+#else
+    x = (x & 0x00FF00FF00FF00FFull) +
+        ((x >> 8) & 0x00FF00FF00FF00FFull);
+    return (size_t)((x * 0x0001000100010001ull) >> 48);
+#endif
+}
+
+size_t my_popcount(uint8_t * src, size_t length) {
+    size_t total = 0;
+
+#if defined (HOST) && defined (__AVX512BITALG__) && defined (__AVX512BW__)
+    __m512i acc512 = _mm512_setzero_si512();
+    while (length >= 64) {
+        __m512i v = _mm512_loadu_si512((void *) src);
+        acc512 = _mm512_add_epi64(acc512,
+                     _mm512_sad_epu8(_mm512_popcnt_epi8(v), _mm512_setzero_si512()));
+        src += 64;
+        length -= 64;
+    }
+    total += (size_t) _mm512_reduce_add_epi64(acc512);
+#elif defined (HOST) && defined (__SSSE3__)
+    const __m128i table = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3,
+                                        1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    __m128i acc = _mm_setzero_si128();
+    while (length >= 16) {
+        __m128i v = _mm_loadu_si128((__m128i *) src);
+        __m128i cnt = _mm_add_epi8(
+            _mm_shuffle_epi8(table, _mm_and_si128(v, nibble)),
+            _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble)));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(cnt, _mm_setzero_si128()));
+        src += 16;
+        length -= 16;
+    }
+    total += (size_t) _mm_cvtsi128_si64(acc) +
+             (size_t) _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc));
+#endif
+
+    while (length >= sizeof(bitword_t)) {
+#if defined (HOST)
+        /* Compiles to POPCNT when the target has it */
+        total += (size_t) __builtin_popcountll(((unaligned_bitword_t *) src)->word);
+#else
+        total += sum_lanes(popcount_lanes(((unaligned_bitword_t *) src)->word));
+#endif
+        src += sizeof(bitword_t);
+        length -= sizeof(bitword_t);
+    }
+
+    while (length--) {
+        total += sum_lanes(popcount_lanes(*src++));
+    }
+    return total;
+}
+
+void my_bitcount_per_position(uint8_t * src, size_t length, size_t * counts) {
+    bitword_t acc[8];
+    size_t pending = 0;
+
+    for (int k = 0; k < 8; k++) {
+        *(counts + k) = 0;
+        *(acc + k) = 0;
+    }
+
+    /*
+     * Each byte lane of acc[k] counts bit k of the bytes in that lane, so a
+     * lane can absorb 255 words before it has to be flushed.
+     */
+    while (length >= sizeof(bitword_t)) {
+        bitword_t x = ((unaligned_bitword_t *) src)->word;
+        for (int k = 0; k < 8; k++) {
+            *(acc + k) += (x >> k) & BITWORD_ONES;
+        }
+        src += sizeof(bitword_t);
+        length -= sizeof(bitword_t);
+
+        if (++pending == 255 || length < sizeof(bitword_t)) {
+            for (int k = 0; k < 8; k++) {
+                *(counts + k) += sum_lanes(*(acc + k));
+                *(acc + k) = 0;
+            }
+            pending = 0;
+        }
+    }
+
+    while (length--) {
+        uint8_t x = *src++;
+        for (int k = 0; k < 8; k++) {
+            *(counts + k) += (x >> k) & 1u;
+        }
+    }
+}
+
 uint32_t * reserve_words(size_t length) {
     uint32_t * ptr = (uint32_t *) malloc(length * sizeof(uint32_t));
     return ptr;  // returns NULL if malloc fails
@@ -105,3 +545,247 @@ uint32_t * reserve_words(size_t length) {
 void free_words(uint32_t * src) {
     free(src);
 }
+
+/*
+ * Load-linked / store-conditional on a pool head. On the Cortex-M4 the
+ * exclusive monitor is cleared by any exception entry or return, so a
+ * store that raced with an interrupt handler always fails and retries.
+ * HOST emulates the pair with a compare-and-swap; the tag in the head
+ * protects it against ABA reuse of a block.
+ */
+static inline uint32_t pool_load_linked(volatile uint32_t * head) {
+#if defined (MSP432)
+    return __LDREXW(head);
+#else
+    return __atomic_load_n(head, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline int pool_store_conditional(volatile uint32_t * head,
+                                         uint32_t expected, uint32_t value) {
+#if defined (MSP432)
+    (void) expected;
+    return __STREXW(value, head) == 0;
+#else
+    return __atomic_compare_exchange_n(head, &expected, value, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void pool_abandon_linked(void) {
+#if defined (MSP432)
+    __CLREX();
+#endif
+}
+
+/* Next tag value, keeping the tag in the high half of the head */
+#define POOL_NEXT_TAG(head) (((head) + 0x10000u) & 0xFFFF0000u)
+
+block_pool_t * block_pool_init(block_pool_t * pool, uint8_t * buffer,
+                               size_t block_size, size_t count) {
+    if (pool == NULL || buffer == NULL || count == 0 ||
+        count > BLOCK_POOL_MAX_BLOCKS ||
+        block_size < sizeof(uint32_t) || block_size % sizeof(uint32_t) != 0) {
+        return NULL;
+    }
+
+    pool->base = buffer;
+    pool->block_size = block_size;
+    pool->count = count;
+
+    /* Link every block to the one after it; the last one ends the list */
+    for (size_t i = 0; i < count; i++) {
+        *(uint32_t *)(buffer + i * block_size) = (i + 1 < count) ? i + 2 : 0;
+    }
+    pool->head = 1;
+    return pool;
+}
+
+uint8_t * block_alloc(block_pool_t * pool) {
+    uint32_t head;
+    uint32_t next;
+    uint8_t * block;
+
+    do {
+        head = pool_load_linked(&pool->head);
+        if ((head & 0xFFFFu) == 0) {
+            pool_abandon_linked();
+            return NULL;
+        }
+        block = pool->base + ((head & 0xFFFFu) - 1) * pool->block_size;
+        next = *(volatile uint32_t *) block;
+    } while (!pool_store_conditional(&pool->head, head,
+                                     POOL_NEXT_TAG(head) | next));
+    return block;
+}
+
+void block_free(block_pool_t * pool, uint8_t * block) {
+    uint32_t index = (uint32_t)((block - pool->base) / pool->block_size) + 1;
+    uint32_t head;
+
+    do {
+        head = pool_load_linked(&pool->head);
+        *(volatile uint32_t *) block = head & 0xFFFFu;
+    } while (!pool_store_conditional(&pool->head, head,
+                                     POOL_NEXT_TAG(head) | index));
+}
+
+void word_vector_init(word_vector_t * vector) {
+    vector->data = vector->inline_words;
+    vector->size = 0;
+    vector->capacity = WORD_VECTOR_INLINE_W;
+    vector->storage = WORD_VECTOR_INLINE;
+}
+
+#ifdef WORD_VECTOR_USE_MREMAP
+/* Rounds a word count up to a whole number of pages */
+static size_t word_vector_map_words(size_t words) {
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t bytes = (words * sizeof(uint32_t) + page - 1) / page * page;
+    return bytes / sizeof(uint32_t);
+}
+#endif
+
+/* Frees heap or mapped storage; inline storage needs no release */
+static void word_vector_release(word_vector_t * vector) {
+#ifdef WORD_VECTOR_USE_MREMAP
+    if (vector->storage == WORD_VECTOR_MAPPED) {
+        munmap(vector->data, vector->capacity * sizeof(uint32_t));
+        return;
+    }
+#endif
+    if (vector->storage == WORD_VECTOR_HEAP) {
+        free_words(vector->data);
+    }
+}
+
+/*
+ * Moves the vector to storage of exactly `capacity` words (capacity must
+ * be at least the current size). Returns NULL and leaves the vector
+ * untouched if allocation fails.
+ */
+static uint32_t * word_vector_resize(word_vector_t * vector, size_t capacity) {
+    uint32_t * data;
+
+    if (capacity <= WORD_VECTOR_INLINE_W) {
+        if (vector->storage != WORD_VECTOR_INLINE) {
+            my_memcopy((uint8_t *) vector->data,
+                       (uint8_t *) vector->inline_words,
+                       vector->size * sizeof(uint32_t));
+            word_vector_release(vector);
+        }
+        vector->data = vector->inline_words;
+        vector->capacity = WORD_VECTOR_INLINE_W;
+        vector->storage = WORD_VECTOR_INLINE;
+        return vector->data;
+    }
+
+#ifdef WORD_VECTOR_USE_MREMAP
+    if (capacity * sizeof(uint32_t) >= WORD_VECTOR_MAP_THRESHOLD_B) {
+        capacity = word_vector_map_words(capacity);
+        if (vector->storage == WORD_VECTOR_MAPPED) {
+            /* Grows or shrinks in place when possible, never copies data */
+            data = mremap(vector->data, vector->capacity * sizeof(uint32_t),
+                          capacity * sizeof(uint32_t), MREMAP_MAYMOVE);
+            if (data == MAP_FAILED) return NULL;
+        } else {
+            data = mmap(NULL, capacity * sizeof(uint32_t),
+                        PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                        -1, 0);
+            if (data == MAP_FAILED) return NULL;
+            my_memcopy((uint8_t *) vector->data, (uint8_t *) data,
+                       vector->size * sizeof(uint32_t));
+            word_vector_release(vector);
+        }
+        vector->data = data;
+        vector->capacity = capacity;
+        vector->storage = WORD_VECTOR_MAPPED;
+        return data;
+    }
+
+    if (vector->storage == WORD_VECTOR_MAPPED) {
+        data = reserve_words(capacity);
+        if (data == NULL) return NULL;
+        my_memcopy((uint8_t *) vector->data, (uint8_t *) data,
+                   vector->size * sizeof(uint32_t));
+        word_vector_release(vector);
+        vector->data = data;
+        vector->capacity = capacity;
+        vector->storage = WORD_VECTOR_HEAP;
+        return data;
+    }
+#endif
+
+    if (vector->storage == WORD_VECTOR_HEAP) {
+        data = (uint32_t *) realloc(vector->data, capacity * sizeof(uint32_t));
+        if (data == NULL) return NULL;
+    } else {
+        data = reserve_words(capacity);
+        if (data == NULL) return NULL;
+        my_memcopy((uint8_t *) vector->data, (uint8_t *) data,
+                   vector->size * sizeof(uint32_t));
+    }
+    vector->data = data;
+    vector->capacity = capacity;
+    vector->storage = WORD_VECTOR_HEAP;
+    return data;
+}
+
+uint32_t * word_vector_reserve(word_vector_t * vector, size_t capacity) {
+    size_t grown;
+
+    if (capacity <= vector->capacity) return vector->data;
+
+    /* Double the capacity so appends stay amortized O(1) */
+    grown = vector->capacity * 2;
+    if (grown < capacity) grown = capacity;
+    return word_vector_resize(vector, grown);
+}
+
+uint32_t * word_vector_push(word_vector_t * vector, uint32_t value) {
+    uint32_t * slot;
+
+    if (vector->size == vector->capacity &&
+        word_vector_reserve(vector, vector->size + 1) == NULL) {
+        return NULL;
+    }
+    slot = vector->data + vector->size++;
+    *slot = value;
+    return slot;
+}
+
+uint32_t * word_vector_append(word_vector_t * vector, uint32_t * src,
+                              size_t length) {
+    uint32_t * first;
+
+    if (word_vector_reserve(vector, vector->size + length) == NULL) {
+        return NULL;
+    }
+    first = vector->data + vector->size;
+    my_memcopy((uint8_t *) src, (uint8_t *) first, length * sizeof(uint32_t));
+    vector->size += length;
+    return first;
+}
+
+uint32_t * word_vector_shrink_to_fit(word_vector_t * vector) {
+    size_t target = vector->size;
+
+#ifdef WORD_VECTOR_USE_MREMAP
+    if (target * sizeof(uint32_t) >= WORD_VECTOR_MAP_THRESHOLD_B) {
+        target = word_vector_map_words(target);
+    }
+#endif
+    if (target == vector->capacity ||
+        (target < WORD_VECTOR_INLINE_W &&
+         vector->storage == WORD_VECTOR_INLINE)) {
+        return vector->data;
+    }
+    /* On failure the larger storage is simply kept */
+    word_vector_resize(vector, target);
+    return vector->data;
+}
+
+void word_vector_free(word_vector_t * vector) {
+    vector->size = 0;
+    word_vector_resize(vector, 0);
+}
@@ -0,0 +1,251 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are 
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material. 
+ *
+ *****************************************************************************/
+/**
+ * @file output.c
+ * @brief Implementation of the buffered output layer
+ *
+ * Text is formatted with my_itoa() and copied with my_memcopy() into a
+ * ring buffer, so printing an array costs one sink call per buffer load
+ * instead of one printf() per element.
+ *
+ * @author
+ * @date
+ *
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include "output.h"
+#include "memory.h"
+#include "data.h"
+#include "platform.h"
+
+#if defined (HOST) && (defined (__unix__) || defined (__APPLE__))
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define OUTPUT_USE_WRITEV
+#endif
+
+#define OUTPUT_MASK (OUTPUT_BUFFER_SIZE - 1)
+
+/*
+ * Preformatted text of every byte value, packed into a word in memory
+ * order (little endian) so one store writes it: "255 " fills all four
+ * bytes, shorter entries leave bytes past their length to be overwritten.
+ */
+#define U8_DIGIT(d) ((uint32_t)((d) < 10 ? '0' + (d) : 'A' - 10 + (d)))
+#define U8_DEC(n) \
+    ((n) >= 100 ? U8_DIGIT((n) / 100) | (U8_DIGIT((n) / 10 % 10) << 8) | \
+                  (U8_DIGIT((n) % 10) << 16) | ((uint32_t) ' ' << 24) : \
+     (n) >= 10  ? U8_DIGIT((n) / 10) | (U8_DIGIT((n) % 10) << 8) | \
+                  ((uint32_t) ' ' << 16) : \
+                  U8_DIGIT(n) | ((uint32_t) ' ' << 8))
+#define U8_DEC_LENGTH(n) ((n) >= 100 ? 4 : (n) >= 10 ? 3 : 2)
+#define U8_HEX(n) \
+    (U8_DIGIT((n) >> 4) | (U8_DIGIT((n) & 0xF) << 8) | ((uint32_t) ' ' << 16))
+#define U8_HEX_LENGTH (3)
+
+#define U8_TABLE4(f, n)  f(n), f(n + 1), f(n + 2), f(n + 3)
+#define U8_TABLE16(f, n) U8_TABLE4(f, n), U8_TABLE4(f, n + 4), \
+                         U8_TABLE4(f, n + 8), U8_TABLE4(f, n + 12)
+#define U8_TABLE64(f, n) U8_TABLE16(f, n), U8_TABLE16(f, n + 16), \
+                         U8_TABLE16(f, n + 32), U8_TABLE16(f, n + 48)
+#define U8_TABLE(f)      U8_TABLE64(f, 0), U8_TABLE64(f, 64), \
+                         U8_TABLE64(f, 128), U8_TABLE64(f, 192)
+
+static const uint32_t u8_dec_chars[256] = { U8_TABLE(U8_DEC) };
+static const uint8_t u8_dec_length[256] = { U8_TABLE(U8_DEC_LENGTH) };
+static const uint32_t u8_hex_chars[256] = { U8_TABLE(U8_HEX) };
+
+/* Bytes formatted per output_reserve() call: four characters each */
+#define U8_BLOCK (OUTPUT_BUFFER_SIZE / 4)
+
+static uint8_t output_buffer[OUTPUT_BUFFER_SIZE];
+static size_t output_head;  /* Total bytes committed */
+static size_t output_tail;  /* Total bytes handed to the sink */
+static output_sink_t output_sink;
+
+/* Default sink when none is installed */
+static size_t output_default_sink(uint8_t * data, size_t length) {
+#if defined (HOST) && !defined (OUTPUT_USE_WRITEV)
+    size_t written = fwrite(data, 1, length, stdout);
+    fflush(stdout);
+    return written;
+#else
+    (void) data;
+    return length;  // no console on the target: discard like PRINTF
+#endif
+}
+
+#if defined (OUTPUT_USE_WRITEV)
+/* Writes both halves of the ring to stdout in one system call */
+static size_t output_writev(size_t start, size_t first, size_t pending) {
+    struct iovec iov[2];
+    ssize_t written;
+
+    iov[0].iov_base = output_buffer + start;
+    iov[0].iov_len = first;
+    iov[1].iov_base = output_buffer;
+    iov[1].iov_len = pending - first;
+    do {
+        written = writev(STDOUT_FILENO, iov, (pending > first) ? 2 : 1);
+    } while (written < 0 && errno == EINTR);
+    return (written > 0) ? (size_t) written : 0;
+}
+#endif
+
+void output_set_sink(output_sink_t sink) {
+    output_sink = sink;
+}
+
+void output_u8_array(uint8_t * array, size_t length, uint8_t format) {
+    while (length > 0) {
+        size_t count = (length < U8_BLOCK) ? length : U8_BLOCK;
+        uint8_t * start = output_reserve(count * 4);
+        uint8_t * ptr = start;
+        uint8_t * end = array + count;
+
+        if (!start) {
+            return;  // sink stalled: drop the rest
+        }
+        if (format == OUTPUT_U8_HEX) {
+            while (array < end) {
+                ((unaligned_word_t *) ptr)->word = *(u8_hex_chars + *array++);
+                ptr += U8_HEX_LENGTH;
+            }
+        } else {
+            while (array < end) {
+                ((unaligned_word_t *) ptr)->word = *(u8_dec_chars + *array);
+                ptr += *(u8_dec_length + *array++);
+            }
+        }
+        output_commit((size_t)(ptr - start));
+        length -= count;
+    }
+}
+
+size_t output_flush(void) {
+#if defined (HOST)
+    fflush(stdout);
+#endif
+    while (output_tail != output_head) {
+        size_t pending = output_head - output_tail;
+        size_t start = output_tail & OUTPUT_MASK;
+        size_t first = OUTPUT_BUFFER_SIZE - start;
+        size_t accepted;
+
+        if (first > pending) {
+            first = pending;
+        }
+#if defined (OUTPUT_USE_WRITEV)
+        if (!output_sink) {
+            accepted = output_writev(start, first, pending);
+        } else
+#endif
+        {
+            accepted = output_sink ? output_sink(output_buffer + start, first)
+                                   : output_default_sink(output_buffer + start,
+                                                         first);
+        }
+        if (accepted == 0) {
+            break;  // sink stalled: keep the rest buffered
+        }
+        output_tail += accepted;
+    }
+
+    if (output_tail == output_head) {
+        /* Empty: restart at the front so reservations stay contiguous */
+        output_head = 0;
+        output_tail = 0;
+    }
+    return output_head - output_tail;
+}
+
+uint8_t * output_reserve(size_t length) {
+    size_t start = output_head & OUTPUT_MASK;
+
+    if (length > OUTPUT_BUFFER_SIZE) {
+        return NULL;
+    }
+    if (OUTPUT_BUFFER_SIZE - (output_head - output_tail) < length ||
+        OUTPUT_BUFFER_SIZE - start < length) {
+        output_flush();
+        start = output_head & OUTPUT_MASK;
+        if (OUTPUT_BUFFER_SIZE - (output_head - output_tail) < length ||
+            OUTPUT_BUFFER_SIZE - start < length) {
+            return NULL;
+        }
+    }
+    return output_buffer + start;
+}
+
+void output_commit(size_t length) {
+    output_head += length;
+}
+
+void output_write(uint8_t * data, size_t length) {
+    while (length > 0) {
+        size_t room = OUTPUT_BUFFER_SIZE - (output_head - output_tail);
+        size_t start = output_head & OUTPUT_MASK;
+        size_t chunk = OUTPUT_BUFFER_SIZE - start;
+
+        if (room == 0) {
+            if (output_flush() == OUTPUT_BUFFER_SIZE) {
+                return;  // sink stalled: drop the rest
+            }
+            continue;
+        }
+        if (chunk > room) {
+            chunk = room;
+        }
+        if (chunk > length) {
+            chunk = length;
+        }
+        my_memcopy(data, output_buffer + start, chunk);
+        output_head += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+void output_string(uint8_t * str) {
+    uint8_t * end = str;
+
+    while (*end) {
+        end++;
+    }
+    output_write(str, (size_t)(end - str));
+}
+
+void output_char(uint8_t c) {
+    uint8_t * ptr = output_reserve(1);
+
+    if (ptr) {
+        *ptr = c;
+        output_commit(1);
+    }
+}
+
+void output_int(int32_t value, uint32_t base) {
+    uint8_t * ptr = output_reserve(ITOA_MAX_SIZE);
+
+    if (ptr) {
+        output_commit(my_itoa(value, ptr, base) - 1);  // drop the terminator
+    }
+}
+
+void output_float(float value) {
+    uint8_t * ptr = output_reserve(FTOA_MAX_CHARS);
+
+    if (ptr) {
+        output_commit(my_ftoa(value, ptr) - 1);  // drop the terminator
+    }
+}
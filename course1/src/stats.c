@@ -12,6 +12,16 @@
 
 #include <stdio.h>
 #include "stats.h"
+#include "output.h"
+#include "memory.h"
+#include "platform.h"
+
+#if defined (HOST) && defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined (HOST) && (defined (__AVX2__) || defined (__AVX512BW__))
+#include <immintrin.h>
+#endif
 
 /* Size of the Data Set */
 #define SIZE (40)
@@ -41,7 +51,9 @@
  * @brief Prints the statistics of an array including minimum, maximum, mean, and median.
  *
  * This function takes an array and its length as inputs and prints the minimum,
- * maximum, mean, and median values of the array.
+ * maximum, mean, median and variance of the array. The values come from
+ * compute_statistics(), so the array is not modified; the mean and
+ * variance are printed unrounded with my_ftoa().
  *
  * @param array The array of unsigned characters.
  * @param length The length of the array.
@@ -49,11 +61,123 @@
  * @return void
  */
 void print_statistics(unsigned char* array, unsigned int length) {
-    printf("Statistics:\n");
-    printf("Minimum: %d\n", find_minimum(array, length));
-    printf("Maximum: %d\n", find_maximum(array, length));
-    printf("Mean: %d\n", find_mean(array, length));
-    printf("Median: %d\n", find_median(array, length));
+    stats_result_t result;
+
+    compute_statistics(array, length, &result);
+    output_string((uint8_t*) "Statistics:\nMinimum: ");
+    output_int(result.minimum, 10);
+    output_string((uint8_t*) "\nMaximum: ");
+    output_int(result.maximum, 10);
+    output_string((uint8_t*) "\nMean: ");
+    output_float(length ? (float) result.sum / (float) length : 0.0f);
+    output_string((uint8_t*) "\nMedian: ");
+    output_int(result.median, 10);
+    output_string((uint8_t*) "\nVariance: ");
+    output_float(result.variance);
+    output_char('\n');
+    output_flush();
+}
+
+/* Walks a histogram to the value of a 0-based ascending rank */
+static unsigned char histogram_rank(unsigned int* counts, uint64_t rank) {
+  uint64_t seen = 0;
+  unsigned int value = 0;
+
+  while (seen + counts[value] <= rank) {
+    seen += counts[value];
+    value++;
+  }
+  return value;
+}
+
+/* Median of a histogram of `length` values, find_median() style: an odd
+ * length has one middle rank, so both walks land on it */
+static unsigned char histogram_median(unsigned int* counts, uint64_t length) {
+  unsigned int low = histogram_rank(counts, (length - 1) / 2);
+  unsigned int high = histogram_rank(counts, length / 2);
+
+  return (low + high) / 2;
+}
+
+/* Fills every other field of `result` from its histogram and length,
+ * which must be at least 1. O(256) whatever the number of values */
+static void histogram_statistics(stats_result_t* result) {
+  unsigned int* counts = result->histogram;
+  unsigned int value;
+  float mean;
+  float deviation;
+  float squares = 0.0f;
+
+  result->sum = 0;
+  result->mode = 0;
+  for (value = 0; value < STATS_HISTOGRAM_BINS; value++) {
+    result->sum += (uint64_t)counts[value] * value;
+    if (counts[value] > counts[result->mode]) {
+      result->mode = value;
+    }
+  }
+  value = 0;
+  while (counts[value] == 0) {
+    value++;
+  }
+  result->minimum = value;
+  value = STATS_HISTOGRAM_BINS - 1;
+  while (counts[value] == 0) {
+    value--;
+  }
+  result->maximum = value;
+  result->mean = result->sum / result->length;
+  result->median = histogram_median(counts, result->length);
+
+  mean = (float)result->sum / (float)result->length;
+  for (value = result->minimum; value <= result->maximum; value++) {
+    deviation = (float)value - mean;
+    squares += (float)counts[value] * deviation * deviation;
+  }
+  result->variance = squares / (float)result->length;
+}
+
+/**
+ * @brief Computes all statistics of an array in one pass.
+ *
+ * This function takes an array and its length as inputs and fills `result`
+ * with the minimum, maximum, sum, mean, median, mode, variance and the full
+ * histogram. The array is read once to build the histogram and everything
+ * else is derived from the 256 bins, so the array is not modified and
+ * nothing is printed. A length of 0 gives all fields 0.
+ *
+ * @param array The array of unsigned characters.
+ * @param length The length of the array.
+ * @param result The structure to fill in.
+ *
+ * @return void
+ */
+void compute_statistics(unsigned char* array, unsigned int length,
+                        stats_result_t* result) {
+  unsigned int* counts = result->histogram;
+  unsigned int value;
+
+  for (value = 0; value < STATS_HISTOGRAM_BINS; value++) {
+    counts[value] = 0;
+  }
+  result->minimum = 0;
+  result->maximum = 0;
+  result->mean = 0;
+  result->median = 0;
+  result->mode = 0;
+  result->length = length;
+  result->sum = 0;
+  result->variance = 0.0f;
+  if (length == 0) {
+    return;
+  }
+
+  /* The only pass over the data */
+  for (unsigned int i = 0; i < length; i++) {
+    counts[array[i]]++;
+  }
+
+  histogram_statistics(result);
 }
 
 /**
@@ -68,11 +192,28 @@ void print_statistics(unsigned char* array, unsigned int length) {
  * @return void
  */
 void print_array(unsigned char* array, unsigned int length) {
-  printf("Array: ");
-  for (unsigned int i = 0; i < length; i++) {
-    printf("%d ", array[i]);
-    }
-    printf("\n");
+  output_string((uint8_t*) "Array: ");
+  output_u8_array(array, length, OUTPUT_U8_DEC);
+  output_char('\n');
+  output_flush();
+}
+
+/**
+ * @brief Prints the array to the screen in hexadecimal.
+ *
+ * This function takes an array and its length as inputs and prints each element
+ * of the array as two hexadecimal digits.
+ *
+ * @param array The array of unsigned characters.
+ * @param length The length of the array.
+ *
+ * @return void
+ */
+void print_array_hex(unsigned char* array, unsigned int length) {
+  output_string((uint8_t*) "Array: ");
+  output_u8_array(array, length, OUTPUT_U8_HEX);
+  output_char('\n');
+  output_flush();
 }
 
 /**
@@ -95,6 +236,316 @@ unsigned char find_median(unsigned char* array, unsigned int length) {
   }
 }
 
+/**
+ * @brief Finds the median value of the array without sorting it.
+ *
+ * This function takes an array and its length as inputs, counts the values
+ * into a 256-bin histogram in one pass, and walks the bins to the middle
+ * element. For an even length the two middle values are averaged the same
+ * way find_median() does. The array is not modified, and the time is O(n)
+ * for any input order.
+ *
+ * @param array The array of unsigned characters.
+ * @param length The length of the array.
+ *
+ * @return The median value of the array, or 0 if the length is 0.
+ */
+unsigned char find_median_histogram(unsigned char* array, unsigned int length) {
+  unsigned int counts[STATS_HISTOGRAM_BINS] = { 0 };
+
+  if (length == 0) {
+    return 0;
+  }
+  for (unsigned int i = 0; i < length; i++) {
+    counts[array[i]]++;
+  }
+  return histogram_median(counts, length);
+}
+
+/* Finds the smallest and largest values in one pass. Wider vectors handle
+ * the bulk and narrow into the next tier down, so each tier only sees what
+ * the one above it left over. length must be at least 1. */
+static void u8_extremes(unsigned char* array, unsigned int length,
+                        unsigned char* minimum, unsigned char* maximum) {
+  unsigned char min = array[0];
+  unsigned char max = array[0];
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  __m128i vmin = _mm_set1_epi8((char) min);
+  __m128i vmax = vmin;
+#if defined (__AVX2__) || defined (__AVX512BW__)
+  __m256i ymin = _mm256_set1_epi8((char) min);
+  __m256i ymax = ymin;
+#endif
+#if defined (__AVX512BW__)
+  __m512i zmin = _mm512_set1_epi8((char) min);
+  __m512i zmax = zmin;
+
+  for (; i + 128 <= length; i += 128) {
+    __m512i a = _mm512_loadu_si512((void*) (array + i));
+    __m512i b = _mm512_loadu_si512((void*) (array + i + 64));
+    zmin = _mm512_min_epu8(zmin, _mm512_min_epu8(a, b));
+    zmax = _mm512_max_epu8(zmax, _mm512_max_epu8(a, b));
+  }
+  ymin = _mm256_min_epu8(_mm512_castsi512_si256(zmin),
+                         _mm512_extracti64x4_epi64(zmin, 1));
+  ymax = _mm256_max_epu8(_mm512_castsi512_si256(zmax),
+                         _mm512_extracti64x4_epi64(zmax, 1));
+#endif
+#if defined (__AVX2__) || defined (__AVX512BW__)
+  for (; i + 64 <= length; i += 64) {
+    __m256i a = _mm256_loadu_si256((__m256i*) (array + i));
+    __m256i b = _mm256_loadu_si256((__m256i*) (array + i + 32));
+    ymin = _mm256_min_epu8(ymin, _mm256_min_epu8(a, b));
+    ymax = _mm256_max_epu8(ymax, _mm256_max_epu8(a, b));
+  }
+  vmin = _mm_min_epu8(_mm256_castsi256_si128(ymin),
+                      _mm256_extracti128_si256(ymin, 1));
+  vmax = _mm_max_epu8(_mm256_castsi256_si128(ymax),
+                      _mm256_extracti128_si256(ymax, 1));
+#endif
+  for (; i + 32 <= length; i += 32) {
+    __m128i a = _mm_loadu_si128((__m128i*) (array + i));
+    __m128i b = _mm_loadu_si128((__m128i*) (array + i + 16));
+    vmin = _mm_min_epu8(vmin, _mm_min_epu8(a, b));
+    vmax = _mm_max_epu8(vmax, _mm_max_epu8(a, b));
+  }
+  vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 8));
+  vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 4));
+  vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 2));
+  vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 1));
+  vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 8));
+  vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 4));
+  vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 2));
+  vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 1));
+  min = (unsigned char) _mm_cvtsi128_si32(vmin);
+  max = (unsigned char) _mm_cvtsi128_si32(vmax);
+#elif defined (MSP432)
+  /* USUB8 sets one GE flag per byte lane where x >= acc; SEL then picks
+   * per lane between its operands, giving a 4-way min and max per word */
+  uint32_t wmin = min * 0x01010101u;
+  uint32_t wmax = wmin;
+
+  for (; i + 4 <= length; i += 4) {
+    uint32_t x = ((unaligned_word_t *) (array + i))->word;
+    __USUB8(x, wmin);
+    wmin = __SEL(wmin, x);
+    __USUB8(x, wmax);
+    wmax = __SEL(x, wmax);
+  }
+  for (unsigned int lane = 0; lane < 32; lane += 8) {
+    if (((wmin >> lane) & 0xFF) < min) {
+      min = (wmin >> lane) & 0xFF;
+    }
+    if (((wmax >> lane) & 0xFF) > max) {
+      max = (wmax >> lane) & 0xFF;
+    }
+  }
+#endif
+  for (; i < length; i++) {
+    if (array[i] < min) {
+      min = array[i];
+    }
+    if (array[i] > max) {
+      max = array[i];
+    }
+  }
+  *minimum = min;
+  *maximum = max;
+}
+
+/* Sums the values with sum-of-absolute-differences against zero, which
+ * adds groups of 8 bytes (HOST) or 4 bytes (MSP432) in one instruction */
+static uint64_t u8_sum(unsigned char* array, unsigned int length) {
+  uint64_t sum = 0;
+  unsigned int i = 0;
+#if defined (HOST) && defined (__SSE2__)
+  __m128i zero = _mm_setzero_si128();
+  __m128i vsum = zero;
+#if defined (__AVX2__) || defined (__AVX512BW__)
+  __m256i ysum = _mm256_setzero_si256();
+#endif
+#if defined (__AVX512BW__)
+  __m512i zsum = _mm512_setzero_si512();
+
+  for (; i + 128 <= length; i += 128) {
+    __m512i a = _mm512_loadu_si512((void*) (array + i));
+    __m512i b = _mm512_loadu_si512((void*) (array + i + 64));
+    zsum = _mm512_add_epi64(zsum, _mm512_sad_epu8(a, _mm512_setzero_si512()));
+    zsum = _mm512_add_epi64(zsum, _mm512_sad_epu8(b, _mm512_setzero_si512()));
+  }
+  ysum = _mm256_add_epi64(_mm512_castsi512_si256(zsum),
+                          _mm512_extracti64x4_epi64(zsum, 1));
+#endif
+#if defined (__AVX2__) || defined (__AVX512BW__)
+  for (; i + 64 <= length; i += 64) {
+    __m256i a = _mm256_loadu_si256((__m256i*) (array + i));
+    __m256i b = _mm256_loadu_si256((__m256i*) (array + i + 32));
+    ysum = _mm256_add_epi64(ysum, _mm256_sad_epu8(a, _mm256_setzero_si256()));
+    ysum = _mm256_add_epi64(ysum, _mm256_sad_epu8(b, _mm256_setzero_si256()));
+  }
+  vsum = _mm_add_epi64(_mm256_castsi256_si128(ysum),
+                       _mm256_extracti128_si256(ysum, 1));
+#endif
+  for (; i + 32 <= length; i += 32) {
+    __m128i a = _mm_loadu_si128((__m128i*) (array + i));
+    __m128i b = _mm_loadu_si128((__m128i*) (array + i + 16));
+    vsum = _mm_add_epi64(vsum, _mm_sad_epu8(a, zero));
+    vsum = _mm_add_epi64(vsum, _mm_sad_epu8(b, zero));
+  }
+  vsum = _mm_add_epi64(vsum, _mm_unpackhi_epi64(vsum, vsum));
+  _mm_storel_epi64((__m128i*) &sum, vsum);
+#elif defined (MSP432)
+  /* At most 1020 per word, so 32 bits hold any array in the address space
+   * of SRAM and flash */
+  uint32_t wsum = 0;
+
+  for (; i + 4 <= length; i += 4) {
+    wsum = __USADA8(((unaligned_word_t *) (array + i))->word, 0, wsum);
+  }
+  sum = wsum;
+#endif
+  for (; i < length; i++) {
+    sum += array[i];
+  }
+  return sum;
+}
+
+/* Ranges this short are finished with an insertion sort */
+#define STATS_SELECT_SMALL (16)
+
+/*
+ * Introselect for one element type. Each round partitions three ways
+ * around a median-of-three pivot, so runs of equal values end the search
+ * at once. After about 2 log2(n) rounds the pivot switches to the median
+ * of medians of groups of 5, which bounds the worst case at O(n) however
+ * the data is ordered. `wide` holds the sum of two values for the even
+ * length median average.
+ */
+#define STATS_DEFINE_SELECT(suffix, type, wide) \
+static void kth_insertion_sort##suffix(type* a, unsigned int n) { \
+  for (unsigned int i = 1; i < n; i++) { \
+    type v = a[i]; \
+    unsigned int j = i; \
+    while (j > 0 && a[j - 1] > v) { \
+      a[j] = a[j - 1]; \
+      j--; \
+    } \
+    a[j] = v; \
+  } \
+} \
+static type kth_select##suffix(type* a, unsigned int n, unsigned int k); \
+/* Sorts each group of 5, gathers the group medians at the front and \
+ * selects their median */ \
+static type kth_median_of_medians##suffix(type* a, unsigned int n) { \
+  unsigned int groups = 0; \
+  for (unsigned int i = 0; i < n; i += 5) { \
+    unsigned int size = (n - i < 5) ? n - i : 5; \
+    type t; \
+    kth_insertion_sort##suffix(a + i, size); \
+    t = a[groups]; \
+    a[groups] = a[i + size / 2]; \
+    a[i + size / 2] = t; \
+    groups++; \
+  } \
+  return kth_select##suffix(a, groups, groups / 2); \
+} \
+/* Moves the value of rank k (0-based, ascending) to a[k]; everything \
+ * before it is no larger and everything after it is no smaller */ \
+static type kth_select##suffix(type* a, unsigned int n, unsigned int k) { \
+  unsigned int lo = 0; \
+  unsigned int hi = n; \
+  unsigned int budget = 0; \
+  for (unsigned int m = n; m > 1; m >>= 1) { \
+    budget += 2; \
+  } \
+  while (hi - lo > STATS_SELECT_SMALL) { \
+    type pivot; \
+    type t; \
+    unsigned int lt = lo; \
+    unsigned int gt = hi; \
+    unsigned int i = lo; \
+    if (budget == 0) { \
+      pivot = kth_median_of_medians##suffix(a + lo, hi - lo); \
+    } else { \
+      type x = a[lo]; \
+      type y = a[lo + (hi - lo) / 2]; \
+      type z = a[hi - 1]; \
+      budget--; \
+      if (x < y) { \
+        pivot = (y < z) ? y : ((x < z) ? z : x); \
+      } else { \
+        pivot = (x < z) ? x : ((y < z) ? z : y); \
+      } \
+    } \
+    /* [lo, lt) < pivot, [lt, gt) == pivot, [gt, hi) > pivot */ \
+    while (i < gt) { \
+      if (a[i] < pivot) { \
+        t = a[lt]; \
+        a[lt++] = a[i]; \
+        a[i++] = t; \
+      } else if (a[i] > pivot) { \
+        t = a[--gt]; \
+        a[gt] = a[i]; \
+        a[i] = t; \
+      } else { \
+        i++; \
+      } \
+    } \
+    if (k < lt) { \
+      hi = lt; \
+    } else if (k >= gt) { \
+      lo = gt; \
+    } else { \
+      return pivot; \
+    } \
+  } \
+  kth_insertion_sort##suffix(a + lo, hi - lo); \
+  return a[k]; \
+} \
+/* Copies to the scratch buffer when there is one, else works in place */ \
+static type* kth_input##suffix(type* array, unsigned int length, \
+                               type* scratch) { \
+  if (scratch) { \
+    my_memcopy((uint8_t*) array, (uint8_t*) scratch, \
+               length * sizeof(type)); \
+    return scratch; \
+  } \
+  return array; \
+} \
+type find_kth##suffix(type* array, unsigned int length, unsigned int k, \
+                      type* scratch) { \
+  if (k >= length) { \
+    return 0; \
+  } \
+  return kth_select##suffix(kth_input##suffix(array, length, scratch), \
+                            length, k); \
+} \
+type find_median_nomutate##suffix(type* array, unsigned int length, \
+                                  type* scratch) { \
+  type* work; \
+  type high; \
+  type low; \
+  if (length == 0) { \
+    return 0; \
+  } \
+  work = kth_input##suffix(array, length, scratch); \
+  high = kth_select##suffix(work, length, length / 2); \
+  if (length % 2) { \
+    return high; \
+  } \
+  /* The lower middle is the largest value in front of the upper one */ \
+  low = work[0]; \
+  for (unsigned int i = 1; i < length / 2; i++) { \
+    low = (work[i] > low) ? work[i] : low; \
+  } \
+  return (type) (((wide) low + high) / 2); \
+}
+
+STATS_DEFINE_SELECT(, unsigned char, unsigned int)
+STATS_DEFINE_SELECT(_u16, uint16_t, uint32_t)
+STATS_DEFINE_SELECT(_i32, int32_t, int64_t)
+
 /**
  * @brief Finds the mean value of the array.
  *
@@ -107,11 +558,10 @@ unsigned char find_median(unsigned char* array, unsigned int length) {
  * @return The mean value of the array.
  */
 unsigned char find_mean(unsigned char* array, unsigned int length) {
-  unsigned int sum = 0;
-  for (unsigned int i = 0; i < length; i++) {
-    sum += array[i];
+  if (length == 0) {
+    return 0;
   }
-  return sum / length;
+  return u8_sum(array, length) / length;
 }
 
 /**
@@ -126,12 +576,10 @@ unsigned char find_mean(unsigned char* array, unsigned int length) {
  * @return The maximum value of the array.
  */
 unsigned char find_maximum(unsigned char* array, unsigned int length) {
-  unsigned char max = array[0];
-  for (unsigned int i = 1; i < length; i++) {
-    if (array[i] > max) {
-      max = array[i];
-    }
-  }
+  unsigned char min;
+  unsigned char max;
+
+  u8_extremes(array, length, &min, &max);
   return max;
 }
 
@@ -147,14 +595,386 @@ unsigned char find_maximum(unsigned char* array, unsigned int length) {
  * @return The minimum value of the array.
  */
 unsigned char find_minimum(unsigned char* array, unsigned int length) {
-  unsigned char min = array[0];
-  for (unsigned int i = 1; i < length; i++) {
-    if (array[i] < min) {
-      min = array[i];
-    }  
-  }
+  unsigned char min;
+  unsigned char max;
+
+  u8_extremes(array, length, &min, &max);
   return min;
 }
+
+/* Blocks are summed in chunks this long, so that count * sum of squares
+ * and sum * sum stay exact in 64 bits */
+#define STATS_BLOCK_CHUNK (65536u)
+
+/* Adds `count` values with the given mean and sum of squared deviations to
+ * the Welford state (Chan et al. parallel combination) */
+static void accumulator_combine(stats_accumulator_t* acc, uint64_t count,
+                                stats_float_t mean, stats_float_t m2) {
+  uint64_t total = acc->count + count;
+  stats_float_t delta = mean - acc->mean;
+  stats_float_t weight = (stats_float_t)count / (stats_float_t)total;
+
+  acc->mean += delta * weight;
+  acc->m2 += m2 + delta * delta * (stats_float_t)acc->count * weight;
+  acc->count = total;
+}
+
+/**
+ * @brief Resets a streaming statistics accumulator.
+ *
+ * @param acc The accumulator to reset.
+ *
+ * @return void
+ */
+void stats_accumulator_init(stats_accumulator_t* acc) {
+  acc->count = 0;
+  acc->sum = 0;
+  acc->mean = 0;
+  acc->m2 = 0;
+  acc->minimum = 0xFF;
+  acc->maximum = 0;
+  for (unsigned int value = 0; value < STATS_HISTOGRAM_BINS; value++) {
+    acc->histogram[value] = 0;
+  }
+}
+
+/**
+ * @brief Adds one value to a streaming statistics accumulator.
+ *
+ * Updates the count, sum, minimum, maximum, histogram and the Welford mean
+ * and variance in constant time.
+ *
+ * @param acc The accumulator to update.
+ * @param value The new sample.
+ *
+ * @return void
+ */
+void stats_accumulator_push(stats_accumulator_t* acc, unsigned char value) {
+  stats_float_t delta = (stats_float_t)value - acc->mean;
+
+  acc->count++;
+  acc->sum += value;
+  acc->histogram[value]++;
+  acc->minimum = (value < acc->minimum) ? value : acc->minimum;
+  acc->maximum = (value > acc->maximum) ? value : acc->maximum;
+  acc->mean += delta / (stats_float_t)acc->count;
+  acc->m2 += delta * ((stats_float_t)value - acc->mean);
+}
+
+/**
+ * @brief Adds a block of values to a streaming statistics accumulator.
+ *
+ * Equivalent to pushing each value, but the block's mean and variance are
+ * computed exactly with integers and combined into the running state
+ * once, so there is no per-value division.
+ *
+ * @param acc The accumulator to update.
+ * @param array The array of unsigned characters.
+ * @param length The length of the array.
+ *
+ * @return void
+ */
+void stats_accumulator_push_block(stats_accumulator_t* acc,
+                                  unsigned char* array, unsigned int length) {
+  unsigned char min;
+  unsigned char max;
+
+  while (length > 0) {
+    unsigned int n = (length < STATS_BLOCK_CHUNK) ? length : STATS_BLOCK_CHUNK;
+    uint64_t sum = u8_sum(array, n);
+    uint64_t squares = 0;
+
+    for (unsigned int i = 0; i < n; i++) {
+      acc->histogram[array[i]]++;
+      squares += (uint32_t)array[i] * array[i];
+    }
+    u8_extremes(array, n, &min, &max);
+    acc->minimum = (min < acc->minimum) ? min : acc->minimum;
+    acc->maximum = (max > acc->maximum) ? max : acc->maximum;
+    acc->sum += sum;
+
+    /* n * sum of squares - sum^2 is n^2 times the block variance, exact */
+    accumulator_combine(acc, n, (stats_float_t)sum / (stats_float_t)n,
+                        (stats_float_t)(n * squares - sum * sum) /
+                        (stats_float_t)n);
+    array += n;
+    length -= n;
+  }
+}
+
+/**
+ * @brief Merges one accumulator into another.
+ *
+ * Afterwards `acc` holds the statistics of both streams, as if every value
+ * pushed to `other` had been pushed to `acc`. Lets separate streams or
+ * interrupt contexts accumulate independently and combine later.
+ *
+ * @param acc The accumulator to merge into.
+ * @param other The accumulator to merge from; it is not changed.
+ *
+ * @return void
+ */
+void stats_accumulator_merge(stats_accumulator_t* acc,
+                             stats_accumulator_t* other) {
+  if (other->count == 0) {
+    return;
+  }
+  accumulator_combine(acc, other->count, other->mean, other->m2);
+  acc->sum += other->sum;
+  acc->minimum = (other->minimum < acc->minimum) ? other->minimum
+                                                 : acc->minimum;
+  acc->maximum = (other->maximum > acc->maximum) ? other->maximum
+                                                 : acc->maximum;
+  for (unsigned int value = 0; value < STATS_HISTOGRAM_BINS; value++) {
+    acc->histogram[value] += other->histogram[value];
+  }
+}
+
+/**
+ * @brief Reports the statistics of everything pushed so far.
+ *
+ * Fills `result` as compute_statistics() would for the concatenation of
+ * all pushed values, with the variance taken from the Welford state. The
+ * accumulator is not changed and can keep receiving values. O(256).
+ *
+ * @param acc The accumulator to read.
+ * @param result The structure to fill in.
+ *
+ * @return void
+ */
+void stats_accumulator_snapshot(stats_accumulator_t* acc,
+                                stats_result_t* result) {
+  compute_statistics(NULL, 0, result);
+  if (acc->count == 0) {
+    return;
+  }
+  for (unsigned int value = 0; value < STATS_HISTOGRAM_BINS; value++) {
+    result->histogram[value] = acc->histogram[value];
+  }
+  result->length = acc->count;
+  histogram_statistics(result);
+  result->variance = (float)(acc->m2 / (stats_float_t)acc->count);
+}
+
+/**
+ * @brief Returns a percentile of everything pushed so far.
+ *
+ * Uses the nearest-rank definition: the smallest pushed value with at least
+ * `percent` percent of the values at or below it. 50 gives the lower
+ * middle value rather than the averaged median.
+ *
+ * @param acc The accumulator to read.
+ * @param percent The percentile, 0 to 100; larger values count as 100.
+ *
+ * @return The percentile value, or 0 if nothing has been pushed.
+ */
+unsigned char stats_accumulator_percentile(stats_accumulator_t* acc,
+                                           unsigned int percent) {
+  uint64_t rank;
+
+  if (acc->count == 0) {
+    return 0;
+  }
+  percent = (percent > 100) ? 100 : percent;
+  rank = (percent * acc->count + 99) / 100;
+  return histogram_rank(acc->histogram, (rank > 0) ? rank - 1 : 0);
+}
+
+/* Folds a ring index that may have passed the end back into range */
+static unsigned int window_wrap(stats_window_t* window, unsigned int index) {
+  return (index >= window->capacity) ? index - window->capacity : index;
+}
+
+/**
+ * @brief Initializes an empty sliding window over caller storage.
+ *
+ * No heap memory is used, so the storage can be a static array sized at
+ * compile time with STATS_WINDOW_BUFFER_SIZE().
+ *
+ * @param window The window to initialize.
+ * @param buffer Pointer to STATS_WINDOW_BUFFER_SIZE(capacity) bytes,
+ *               at least 2-byte aligned.
+ * @param capacity Number of most recent samples the statistics cover
+ *                 (1 to STATS_WINDOW_MAX_CAPACITY).
+ *
+ * @return Pointer to the window, or NULL if the parameters are invalid.
+ */
+stats_window_t* stats_window_init(stats_window_t* window, uint8_t* buffer,
+                                  unsigned int capacity) {
+  if (!window || !buffer || ((uintptr_t) buffer & 1) || capacity == 0 ||
+      capacity > STATS_WINDOW_MAX_CAPACITY) {
+    return NULL;
+  }
+  window->min_deque = (uint16_t*) buffer;
+  window->max_deque = (uint16_t*) buffer + capacity;
+  window->samples = buffer + 4 * capacity;
+  window->capacity = capacity;
+  window->count = 0;
+  window->next = 0;
+  window->min_head = 0;
+  window->min_length = 0;
+  window->max_head = 0;
+  window->max_length = 0;
+  window->sum = 0;
+  window->below = 0;
+  window->cursor = 0;
+  for (unsigned int value = 0; value < STATS_HISTOGRAM_BINS; value++) {
+    window->histogram[value] = 0;
+  }
+  return window;
+}
+
+/**
+ * @brief Adds a sample to a sliding window.
+ *
+ * Once the window is full the oldest sample drops out. The running sum and
+ * histogram are updated in constant time, the minimum and maximum deques
+ * in amortized constant time, and the median cursor moves at most to the
+ * next occupied histogram bin.
+ *
+ * @param window The window to update.
+ * @param value The new sample.
+ *
+ * @return void
+ */
+void stats_window_push(stats_window_t* window, unsigned char value) {
+  unsigned int* counts = window->histogram;
+  unsigned int position = window->next;
+  unsigned int back;
+  unsigned int low_rank;
+
+  /* The oldest sample drops out; if it was a deque candidate it is the
+   * front, because both deques are ordered oldest first */
+  if (window->count == window->capacity) {
+    unsigned char old = window->samples[position];
+
+    window->sum -= old;
+    counts[old]--;
+    window->below -= (old < window->cursor);
+    if (window->min_deque[window->min_head] == position) {
+      window->min_head = window_wrap(window, window->min_head + 1);
+      window->min_length--;
+    }
+    if (window->max_deque[window->max_head] == position) {
+      window->max_head = window_wrap(window, window->max_head + 1);
+      window->max_length--;
+    }
+  } else {
+    window->count++;
+  }
+
+  window->samples[position] = value;
+  window->sum += value;
+  counts[value]++;
+  window->below += (value < window->cursor);
+
+  /* Older candidates that can never again be the minimum (or maximum)
+   * while the new sample is in the window leave from the back */
+  while (window->min_length > 0) {
+    back = window_wrap(window, window->min_head + window->min_length - 1);
+    if (window->samples[window->min_deque[back]] < value) {
+      break;
+    }
+    window->min_length--;
+  }
+  window->min_deque[window_wrap(window, window->min_head +
+                                window->min_length)] = position;
+  window->min_length++;
+  while (window->max_length > 0) {
+    back = window_wrap(window, window->max_head + window->max_length - 1);
+    if (window->samples[window->max_deque[back]] > value) {
+      break;
+    }
+    window->max_length--;
+  }
+  window->max_deque[window_wrap(window, window->max_head +
+                                window->max_length)] = position;
+  window->max_length++;
+  window->next = window_wrap(window, position + 1);
+
+  /* Move the cursor to the bin holding the lower middle rank */
+  low_rank = (window->count - 1) / 2;
+  while (window->below > low_rank) {
+    window->cursor--;
+    window->below -= counts[window->cursor];
+  }
+  while (window->below + counts[window->cursor] <= low_rank) {
+    window->below += counts[window->cursor];
+    window->cursor++;
+  }
+}
+
+/**
+ * @brief Returns the smallest sample in a sliding window.
+ *
+ * @param window The window to read.
+ *
+ * @return The minimum, or 0 if the window is empty.
+ */
+unsigned char stats_window_minimum(stats_window_t* window) {
+  if (window->count == 0) {
+    return 0;
+  }
+  return window->samples[window->min_deque[window->min_head]];
+}
+
+/**
+ * @brief Returns the largest sample in a sliding window.
+ *
+ * @param window The window to read.
+ *
+ * @return The maximum, or 0 if the window is empty.
+ */
+unsigned char stats_window_maximum(stats_window_t* window) {
+  if (window->count == 0) {
+    return 0;
+  }
+  return window->samples[window->max_deque[window->max_head]];
+}
+
+/**
+ * @brief Returns the mean of a sliding window, truncated as find_mean() does.
+ *
+ * @param window The window to read.
+ *
+ * @return The mean, or 0 if the window is empty.
+ */
+unsigned char stats_window_mean(stats_window_t* window) {
+  if (window->count == 0) {
+    return 0;
+  }
+  return window->sum / window->count;
+}
+
+/**
+ * @brief Returns the median of a sliding window.
+ *
+ * Gives the same value as find_median() over the samples in the window,
+ * averaging the two middle values for an even count.
+ *
+ * @param window The window to read.
+ *
+ * @return The median, or 0 if the window is empty.
+ */
+unsigned char stats_window_median(stats_window_t* window) {
+  unsigned int high = window->cursor;
+
+  if (window->count == 0) {
+    return 0;
+  }
+  if (window->count % 2) {
+    return window->cursor;
+  }
+  /* The upper middle is in the cursor bin or the next occupied one */
+  if (window->below + window->histogram[high] <= window->count / 2) {
+    high++;
+    while (window->histogram[high] == 0) {
+      high++;
+    }
+  }
+  return (window->cursor + high) / 2;
+}
+
 /**
  * @brief Sorts the array from largest to smallest.
  *
@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are 
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material. 
+ *
+ *****************************************************************************/
+/**
+ * @file dlog_decode.c
+ * @brief HOST tool that turns deferred log records back into text
+ *
+ * Usage: dlog_decode <format-file> [log-file]
+ *
+ * The format file is the `dlog_fmt` section extracted from the firmware
+ * by `make dlog`. The log file (standard input if omitted) holds the raw
+ * little-endian words written by dlog_flush().
+ *
+ * @author
+ * @date
+ *
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dlog.h"
+
+/* Reads a whole file into a NUL-terminated heap buffer */
+static char * read_file(FILE * file, size_t * length) {
+    size_t capacity = 4096;
+    size_t used = 0;
+    char * data = malloc(capacity + 1);
+
+    while (data) {
+        size_t got = fread(data + used, 1, capacity - used, file);
+        used += got;
+        if (used < capacity) {
+            break;
+        }
+        capacity *= 2;
+        char * grown = realloc(data, capacity + 1);
+        if (!grown) {
+            free(data);
+            return NULL;
+        }
+        data = grown;
+    }
+    if (data) {
+        *(data + used) = '\0';
+        *length = used;
+    }
+    return data;
+}
+
+static uint32_t load_le32(uint8_t * src) {
+    return (uint32_t) *src | ((uint32_t) *(src + 1) << 8) |
+           ((uint32_t) *(src + 2) << 16) | ((uint32_t) *(src + 3) << 24);
+}
+
+/*
+ * Prints one record. Each conversion is printed with its own flags, width
+ * and precision but without length modifiers, since every argument was
+ * stored as one 32-bit word.
+ */
+static void print_record(char * fmt, uint32_t * args, uint32_t count) {
+    uint32_t next = 0;
+
+    while (*fmt) {
+        char spec[32];
+        size_t length = 1;
+
+        if (*fmt != '%') {
+            putchar(*fmt++);
+            continue;
+        }
+        if (*(fmt + 1) == '%') {
+            putchar('%');
+            fmt += 2;
+            continue;
+        }
+
+        spec[0] = *fmt++;
+        while (*fmt && strchr("-+ #0123456789.", *fmt) &&
+               length < sizeof(spec) - 2) {
+            spec[length++] = *fmt++;
+        }
+        while (*fmt && strchr("hlLqjzt", *fmt)) {
+            fmt++;
+        }
+        if (!*fmt) {
+            break;
+        }
+        spec[length++] = *fmt;
+        spec[length] = '\0';
+
+        if (next >= count) {
+            printf("<missing>");
+        } else if (strchr("di", *fmt)) {
+            printf(spec, (int) (int32_t) args[next++]);
+        } else if (strchr("uoxXc", *fmt)) {
+            printf(spec, (unsigned int) args[next++]);
+        } else {
+            printf("<0x%08x>", (unsigned int) args[next++]);
+        }
+        fmt++;
+    }
+}
+
+int main(int argc, char ** argv) {
+    FILE * fmt_file;
+    FILE * log_file = stdin;
+    char * formats;
+    uint8_t * log;
+    size_t formats_length;
+    size_t log_length;
+    size_t offset = 0;
+
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <format-file> [log-file]\n", argv[0]);
+        return 1;
+    }
+    fmt_file = fopen(argv[1], "rb");
+    if (!fmt_file) {
+        perror(argv[1]);
+        return 1;
+    }
+    if (argc == 3) {
+        log_file = fopen(argv[2], "rb");
+        if (!log_file) {
+            perror(argv[2]);
+            return 1;
+        }
+    }
+    formats = read_file(fmt_file, &formats_length);
+    log = (uint8_t *) read_file(log_file, &log_length);
+    if (!formats || !log) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    while (offset + 4 <= log_length) {
+        uint32_t header = load_le32(log + offset);
+        uint32_t args[DLOG_MAX_ARGS];
+        uint32_t count = DLOG_HEADER_COUNT(header);
+        uint32_t id = DLOG_HEADER_ID(header);
+
+        if (!DLOG_HEADER_VALID(header) || count > DLOG_MAX_ARGS ||
+            offset + 4 * (count + 1) > log_length) {
+            fprintf(stderr, "bad record at byte %zu\n", offset);
+            return 1;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            args[i] = load_le32(log + offset + 4 * (i + 1));
+        }
+        if (id >= formats_length) {
+            printf("<unknown format %u>\n", (unsigned int) id);
+        } else {
+            print_record(formats + id, args, count);
+        }
+        offset += 4 * (count + 1);
+    }
+    return 0;
+}